@@ -0,0 +1,77 @@
+#include "Benchmark.h"
+
+#include <QJsonArray>
+
+#include <Log.h>
+
+void Benchmark::report(const Result& result)
+{
+	LOG_INFO(result.name.toStdString() << ": " << result.median << "ms median, "
+			<< result.min << "ms min (" << result.iterations << " runs)");
+
+	m_results.push_back(result);
+}
+
+QJsonObject Benchmark::toJson() const
+{
+	QJsonArray results;
+	for(auto& r : m_results)
+	{
+		QJsonObject json;
+		json["name"] = r.name;
+		json["iterations"] = static_cast<qint64>(r.iterations);
+		json["median"] = r.median;
+		json["min"] = r.min;
+		results.append(json);
+	}
+
+	QJsonObject json;
+	json["results"] = results;
+	return json;
+}
+
+bool Benchmark::compare(const QJsonObject& baseline, double tolerance, bool strict) const
+{
+	const auto medians = baseline["results"].toObject();
+	bool passed = true;
+
+	for(auto& r : m_results)
+	{
+		// A stale or empty baseline lets regressions through, strict runs catch that
+		if(!medians.contains(r.name))
+		{
+			if(strict)
+			{
+				LOG_ERROR("No baseline for " << r.name.toStdString() << ", record one with --update-baseline");
+				passed = false;
+			}
+			else
+				LOG_WARNING("No baseline for " << r.name.toStdString() << ", record one with --update-baseline");
+
+			continue;
+		}
+
+		const double expected = medians[r.name].toDouble();
+		const double limit = expected * (1.0 + tolerance);
+		if(r.median > limit)
+		{
+			LOG_ERROR("Regression in " << r.name.toStdString() << ": " << r.median
+					<< "ms, baseline " << expected << "ms (limit " << limit << "ms)");
+			passed = false;
+		}
+	}
+
+	return passed;
+}
+
+QJsonObject Benchmark::toBaseline(double tolerance) const
+{
+	QJsonObject medians;
+	for(auto& r : m_results)
+		medians[r.name] = r.median;
+
+	QJsonObject json;
+	json["tolerance"] = tolerance;
+	json["results"] = medians;
+	return json;
+}
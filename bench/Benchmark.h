@@ -0,0 +1,99 @@
+#ifndef NEOEDITOR_BENCHMARK_H
+#define NEOEDITOR_BENCHMARK_H
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QString>
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * Minimal harness for the editor micro benchmarks.
+ *
+ * Every benchmark is run repeatedly until it took at least MIN_TIME_MS and
+ * MIN_ITERATIONS runs, the median and minimum time of a run are recorded.
+ * Results are compared against a baseline of medians, anything slower than
+ * the baseline by more than the tolerance counts as a regression.
+ */
+class Benchmark
+{
+public:
+	struct Result
+	{
+		QString name; ///< "Function/objects"
+		size_t iterations = 0;
+		double median = 0, min = 0; // In ms
+	};
+
+	static constexpr double MIN_TIME_MS = 250.0;
+	static constexpr size_t MIN_ITERATIONS = 5;
+	static constexpr size_t MAX_ITERATIONS = 1000;
+
+	/// Only runs benchmarks whose name matches
+	void setFilter(const QString& filter) { m_filter = QRegularExpression(filter); }
+
+	template<typename Fn>
+	void run(const QString& name, size_t objects, Fn fn)
+	{
+		run(name, objects, [](){}, fn);
+	}
+
+	/// Calls setup before every run without measuring it
+	template<typename Setup, typename Fn>
+	void run(const QString& name, size_t objects, Setup setup, Fn fn)
+	{
+		const QString fullName = name + "/" + QString::number(objects);
+		if(!m_filter.match(fullName).hasMatch())
+			return;
+
+		std::vector<double> times;
+		double total = 0;
+		QElapsedTimer timer;
+
+		while((total < MIN_TIME_MS || times.size() < MIN_ITERATIONS) && times.size() < MAX_ITERATIONS)
+		{
+			setup();
+
+			timer.start();
+			fn();
+			const double t = timer.nsecsElapsed() / 1e6;
+
+			times.push_back(t);
+			total += t;
+		}
+
+		std::sort(times.begin(), times.end());
+
+		Result result;
+		result.name = fullName;
+		result.iterations = times.size();
+		result.median = times[times.size() / 2];
+		result.min = times.front();
+		report(result);
+	}
+
+	const std::vector<Result>& getResults() const { return m_results; }
+
+	QJsonObject toJson() const;
+
+	/**
+	 * Compares the medians with the baseline and logs every regression.
+	 *
+	 * @param strict Benchmarks without a baseline entry fail instead of only being reported.
+	 * @return false if any benchmark is slower than the baseline allows.
+	 */
+	bool compare(const QJsonObject& baseline, double tolerance, bool strict = false) const;
+
+	/// A baseline from the current results
+	QJsonObject toBaseline(double tolerance) const;
+
+private:
+	void report(const Result& result);
+
+	std::vector<Result> m_results;
+	QRegularExpression m_filter;
+};
+
+#endif // NEOEDITOR_BENCHMARK_H
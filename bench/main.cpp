@@ -0,0 +1,240 @@
+#include "Benchmark.h"
+
+#include <ConsoleStream.h>
+#include <UndoActions.h>
+#include <platform/EditorWidget.h>
+#include <widgets/LevelTreeWidget.h>
+#include <widgets/ObjectWidget.h>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QPlainTextEdit>
+#include <QTemporaryDir>
+
+#include <ThreadPool.h>
+#include <Level.h>
+#include <LevelLoader.h>
+#include <JsonScene.h>
+#include <BinaryScene.h>
+#include <Log.h>
+#include <behaviors/LightBehavior.h>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+using namespace Neo;
+
+namespace
+{
+
+constexpr size_t FANOUT = 10; // Children per object in the synthetic hierarchy
+constexpr size_t LIGHT_EVERY = 10; // Every n-th object gets a light with properties
+constexpr size_t RAYS = 100; // Rays per picking run
+
+/// A balanced hierarchy of objects laid out on a grid, some of them with behaviors
+void buildLevel(Level& level, size_t count)
+{
+	std::vector<ObjectHandle> objects;
+	objects.reserve(count);
+
+	const size_t side = static_cast<size_t>(std::ceil(std::cbrt(static_cast<double>(count))));
+	for(size_t i = 0; i < count; i++)
+	{
+		auto object = level.addObject(("Object" + std::to_string(i)).c_str());
+		object->setParent(i < FANOUT ? level.getRoot() : objects[(i - FANOUT) / FANOUT]);
+		object->setPosition(Vector3(i % side, (i / side) % side, i / (side * side)) * 2.0f);
+		object->updateMatrix();
+
+		if(i % LIGHT_EVERY == 0)
+			object->addBehavior<LightBehavior>();
+
+		objects.push_back(object);
+	}
+}
+
+ObjectHandle findObject(EditorWidget& editor, size_t index)
+{
+	return editor.getNameIndex().find("Object" + std::to_string(index));
+}
+
+bool writeJson(const QJsonObject& json, const QString& file)
+{
+	QFile out(file);
+	const auto data = QJsonDocument(json).toJson();
+	if(!out.open(QFile::WriteOnly | QFile::Truncate) || out.write(data) != data.size())
+	{
+		LOG_ERROR("Could not write " << file.toStdString());
+		return false;
+	}
+
+	return true;
+}
+
+void runBenchmarks(Benchmark& bench, size_t count)
+{
+	LOG_INFO("Running benchmarks with " << count << " objects");
+
+	EditorWidget editor(nullptr);
+	LevelTreeWidget tree(nullptr);
+	ObjectWidget objectWidget(nullptr);
+
+	auto level = std::make_shared<Level>();
+	level->getPhysicsContext().setEnabled(false);
+	buildLevel(*level, count);
+
+	editor.setLevel(level);
+	tree.setLevel(level);
+	tree.setJournal(&editor.getJournal());
+	objectWidget.setLevel(level);
+
+	// Undo snapshots
+	{
+		FullSceneEditCommand command(editor);
+		bench.run("FullSceneEditCommand::setUndo", count, [&]() { command.setUndo(); });
+
+		// Includes waiting for the compression of the snapshot
+		bench.run("FullSceneEditCommand::undo", count, [&]() { command.undo(); });
+	}
+
+	// Level tree, the undo replaced all objects so start over
+	tree.setLevel(level);
+	bench.run("LevelTreeWidget::levelChangedSlot(reset)", count,
+		[&]() { editor.getJournal().reset(); },
+		[&]() { tree.levelChangedSlot(); });
+
+	const size_t renamed = std::max<size_t>(1, count / 100);
+	size_t renameRound = 0;
+	bench.run("LevelTreeWidget::levelChangedSlot(rename 1%)", count,
+		[&]() {
+			for(size_t i = 0; i < renamed; i++)
+			{
+				auto object = findObject(editor, i * 100 % count);
+				if(object.empty())
+					continue;
+
+				const std::string oldName = object->getName().str();
+				object->setName((oldName + "_" + std::to_string(renameRound)).c_str());
+				editor.getJournal().record(LevelJournal::OBJECT_RENAMED, object, ObjectHandle(), oldName);
+				object->setName(oldName.c_str());
+			}
+			renameRound++;
+		},
+		[&]() { tree.levelChangedSlot(); });
+
+	// Property panel
+	auto light = findObject(editor, 0);
+	bench.run("ObjectWidget::setObject", count, [&]() { objectWidget.setObject(light); });
+	bench.run("ObjectWidget::updateObject", count, [&]() { objectWidget.updateObject(light); });
+
+	bench.run("EditorWidget::makePathsRelative", count, [&]() { editor.makePathsRelative(QDir::tempPath().toStdString()); });
+
+	// Console, one line per object
+	{
+		QPlainTextEdit output;
+		ConsoleStream console;
+		console.setOutput(&output);
+
+		// The buffer mirrors everything to stdout, which is not what is measured here
+		std::stringstream sink;
+		auto* stdoutBuffer = std::cout.rdbuf(sink.rdbuf());
+
+		bench.run("ConsoleBuffer", count,
+			[&]() { output.clear(); sink.str(std::string()); },
+			[&]() {
+				for(size_t i = 0; i < count; i++)
+					console << "Benchmark console line " << i << std::endl;
+			});
+
+		std::cout.rdbuf(stdoutBuffer);
+	}
+
+	// Loading and saving
+	{
+		QTemporaryDir dir;
+		const auto file = dir.filePath("level.nlv").toStdString();
+
+		bench.run("LevelLoader::save", count, [&]() { LevelLoader::save(*level, file.c_str()); });
+
+		Level loaded;
+		bench.run("LevelLoader::load", count,
+			[&]() { loaded.clearObjects(); },
+			[&]() { LevelLoader::load(loaded, file.c_str()); });
+	}
+
+	// Picking, rays from outside of the grid towards random objects
+	{
+		std::mt19937 random(1234);
+		std::vector<Vector3> directions;
+		const Vector3 origin(-10, -10, 10);
+		for(size_t i = 0; i < RAYS; i++)
+		{
+			auto object = findObject(editor, random() % count);
+			directions.push_back((object->getGlobalPosition() - origin).getNormalized());
+		}
+
+		bench.run("Level::castRay", count, [&]() {
+			Vector3 hit;
+			ObjectHandle object;
+			for(auto& direction : directions)
+				level->castRay(origin, direction, 1000000.0f, &hit, &object);
+		});
+	}
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	Neo::ThreadPool::start();
+
+	Neo::BinaryScene binLoader;
+	Neo::JsonScene jsonLoader;
+	Neo::LevelLoader::registerLoader(&binLoader);
+	Neo::LevelLoader::registerLoader(&jsonLoader);
+
+	QApplication a(argc, argv);
+
+	QCommandLineParser parser;
+	parser.addHelpOption();
+	QCommandLineOption sizesOption("sizes", "Comma separated object counts of the synthetic levels.", "counts", "1000,10000,100000");
+	QCommandLineOption filterOption("filter", "Only runs benchmarks matching the regular expression.", "regex", ".*");
+	QCommandLineOption outputOption("output", "Writes the results as JSON into <file>.", "file");
+	QCommandLineOption baselineOption("baseline", "Fails if a benchmark is slower than in the baseline <file>.", "file");
+	QCommandLineOption toleranceOption("tolerance", "Allowed slowdown relative to the baseline, overrides the one of the baseline.", "fraction");
+	QCommandLineOption updateOption("update-baseline", "Writes the results into the baseline file instead of comparing.");
+	QCommandLineOption strictOption("strict", "Also fails for benchmarks which are missing from the baseline.");
+	parser.addOptions({sizesOption, filterOption, outputOption, baselineOption, toleranceOption, updateOption, strictOption});
+	parser.process(a);
+
+	Benchmark bench;
+	bench.setFilter(parser.value(filterOption));
+
+	for(auto& size : parser.value(sizesOption).split(',', QString::SkipEmptyParts))
+		runBenchmarks(bench, size.toULongLong());
+
+	if(parser.isSet(outputOption) && !writeJson(bench.toJson(), parser.value(outputOption)))
+		return 1;
+
+	if(!parser.isSet(baselineOption))
+		return 0;
+
+	const auto baselineFile = parser.value(baselineOption);
+	QJsonObject baseline;
+
+	QFile in(baselineFile);
+	if(in.open(QFile::ReadOnly))
+		baseline = QJsonDocument::fromJson(in.readAll()).object();
+
+	double tolerance = baseline["tolerance"].toDouble(0.25);
+	if(parser.isSet(toleranceOption))
+		tolerance = parser.value(toleranceOption).toDouble();
+
+	if(parser.isSet(updateOption))
+		return writeJson(bench.toBaseline(tolerance), baselineFile) ? 0 : 1;
+
+	return bench.compare(baseline, tolerance, parser.isSet(strictOption)) ? 0 : 1;
+}
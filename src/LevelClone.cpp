@@ -0,0 +1,55 @@
+#include "LevelClone.h"
+#include "ObjectAllocator.h"
+
+#include <Behavior.h>
+#include <Object.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+void cloneLevel(Neo::Level& source, Neo::Level& destination)
+{
+	destination.clearObjects();
+
+	// Source object and the parent of its copy
+	std::vector<std::pair<Neo::ObjectHandle, Neo::ObjectHandle>> stack;
+	for(auto& child : source.getRoot()->getChildren())
+		stack.emplace_back(child, destination.getRoot());
+
+	while(!stack.empty())
+	{
+		auto object = stack.back().first;
+		auto parent = stack.back().second;
+		stack.pop_back();
+
+		if(ObjectAllocator::isDead(object))
+			continue;
+
+		auto copy = destination.addObject(object->getName().str());
+		copy->setParent(parent);
+		copy->setPosition(object->getPosition());
+		copy->setRotation(object->getRotation());
+		copy->setScale(object->getScale());
+		copy->updateMatrix();
+		copy->setActive(object->isActive());
+
+		for(auto& behavior : object->getBehaviors())
+		{
+			std::unique_ptr<Neo::Behavior> b(behavior->getNew());
+			if(!b)
+				throw std::runtime_error(std::string("Could not copy behavior ") + behavior->getName());
+
+			// Copies the references to assets, not the assets themselves
+			behavior->copyTo(*b);
+			copy->addBehavior(std::move(b));
+		}
+
+		auto& children = object->getChildren();
+		for(auto iter = children.rbegin(); iter != children.rend(); iter++)
+			stack.emplace_back(*iter, copy);
+	}
+
+	destination.setMainCameraName(source.getMainCameraName());
+}
@@ -0,0 +1,18 @@
+#ifndef NEOEDITOR_LEVELCLONE_H
+#define NEOEDITOR_LEVELCLONE_H
+
+#include <Level.h>
+
+/**
+ * Copies all live objects and their behaviors from one level into another.
+ *
+ * Only object and behavior state is duplicated, assets like meshes, textures
+ * and sounds stay owned by the source level and are shared by reference.
+ * The source level thus needs to outlive the destination!
+ *
+ * Throws if a behavior can not be copied, the destination is left in an
+ * undefined state in this case.
+ */
+void cloneLevel(Neo::Level& source, Neo::Level& destination);
+
+#endif // NEOEDITOR_LEVELCLONE_H
@@ -0,0 +1,20 @@
+#include "LevelJournal.h"
+
+LevelJournal::LevelJournal(size_t capacity):
+	m_events(capacity)
+{ }
+
+void LevelJournal::record(EVENT_TYPE type, Neo::ObjectHandle object, Neo::ObjectHandle parent, const std::string& detail)
+{
+	auto& event = m_events[m_head % m_events.size()];
+	event.sequence = m_head;
+	event.type = type;
+	event.object = object;
+	event.parent = parent;
+	event.detail = detail;
+
+	if(type == LEVEL_RESET)
+		m_lastReset = m_head;
+
+	m_head++;
+}
@@ -0,0 +1,80 @@
+#ifndef NEOEDITOR_LEVELJOURNAL_H
+#define NEOEDITOR_LEVELJOURNAL_H
+
+#include <Object.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Records the edits done to the editor level so panels can update with the
+ * changes since they last looked instead of rebuilding from the whole level.
+ *
+ * Events are sequence numbered and kept in a ring buffer. Every consumer keeps
+ * its own cursor (the next sequence it wants to see) and reads the delta with
+ * read(). If the consumer fell behind so far that events were overwritten, or
+ * the level was replaced, read() tells it to rebuild from scratch instead.
+ * A new consumer starts with a cursor of 0 and thus always rebuilds first.
+ */
+class LevelJournal
+{
+public:
+	enum EVENT_TYPE
+	{
+		OBJECT_ADDED, ///< parent: The new parent
+		OBJECT_REMOVED, ///< parent: The parent it was removed from, detail: The name it had
+		OBJECT_REPARENTED, ///< parent: The new parent
+		OBJECT_RENAMED, ///< detail: The old name
+		OBJECT_TRANSFORMED,
+		BEHAVIORS_CHANGED, ///< Behaviors were added or removed
+		PROPERTY_CHANGED, ///< detail: "Behavior/Property"
+		LEVEL_RESET ///< The whole level was replaced, all handles are invalid
+	};
+
+	struct Event
+	{
+		uint64_t sequence = 0;
+		EVENT_TYPE type = LEVEL_RESET;
+		Neo::ObjectHandle object;
+		Neo::ObjectHandle parent;
+		std::string detail;
+	};
+
+	explicit LevelJournal(size_t capacity = 4096);
+
+	void record(EVENT_TYPE type, Neo::ObjectHandle object, Neo::ObjectHandle parent = Neo::ObjectHandle(), const std::string& detail = std::string());
+	void reset() { record(LEVEL_RESET, Neo::ObjectHandle()); }
+
+	/// The sequence the next event will get, a consumer at this cursor is up to date
+	uint64_t head() const { return m_head; }
+
+	/**
+	 * Calls fn(const Event&) for every event since the cursor and advances it.
+	 *
+	 * @return false if the events since the cursor are not available anymore or
+	 * contain a LEVEL_RESET. In this case no events are passed to fn, the cursor
+	 * is moved to the head and the consumer needs to rebuild its state.
+	 */
+	template<typename Fn>
+	bool read(uint64_t& cursor, Fn fn) const
+	{
+		if(cursor + m_events.size() < m_head || m_lastReset >= cursor)
+		{
+			cursor = m_head;
+			return false;
+		}
+
+		for(; cursor < m_head; cursor++)
+			fn(m_events[cursor % m_events.size()]);
+
+		return true;
+	}
+
+private:
+	std::vector<Event> m_events;
+	uint64_t m_head = 0;
+	uint64_t m_lastReset = 0;
+};
+
+#endif // NEOEDITOR_LEVELJOURNAL_H
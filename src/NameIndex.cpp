@@ -0,0 +1,120 @@
+#include "NameIndex.h"
+
+NameIndex::NameIndex(LevelJournal& journal):
+	m_journal(journal)
+{ }
+
+void NameIndex::setLevel(std::shared_ptr<Neo::Level> level)
+{
+	m_level = level;
+
+	// Start from scratch with the next query
+	m_cursor = 0;
+}
+
+Neo::ObjectHandle NameIndex::find(const std::string& name)
+{
+	if(!m_level)
+		return Neo::ObjectHandle();
+
+	sync();
+
+	auto range = m_names.equal_range(name);
+	for(auto iter = range.first; iter != range.second;)
+	{
+		// Guard against renames which bypassed the journal
+		if(iter->second->getName().str() != name)
+		{
+			iter = m_names.erase(iter);
+			continue;
+		}
+
+		return iter->second;
+	}
+
+	return Neo::ObjectHandle();
+}
+
+std::string NameIndex::getUniqueName(const std::string& base)
+{
+	if(find(base).empty())
+		return base;
+
+	auto& counter = m_counters[base];
+	std::string name;
+
+	do
+	{
+		name = base + std::to_string(++counter);
+	} while(!find(name).empty());
+
+	return name;
+}
+
+void NameIndex::sync()
+{
+	if(!m_level)
+		return;
+
+	const bool complete = m_journal.read(m_cursor, [this](const LevelJournal::Event& e) {
+		switch(e.type)
+		{
+		case LevelJournal::OBJECT_ADDED:
+			insert(e.object);
+			break;
+
+		case LevelJournal::OBJECT_REMOVED:
+			erase(e.detail, e.object);
+			break;
+
+		case LevelJournal::OBJECT_RENAMED:
+			erase(e.detail, e.object);
+			insert(e.object);
+			break;
+
+		default: break;
+		}
+	});
+
+	if(!complete)
+		rebuild();
+}
+
+void NameIndex::rebuild()
+{
+	m_names.clear();
+	m_counters.clear();
+
+	for(auto& object : m_level->getObjects())
+		insert(object.getSelf());
+}
+
+void NameIndex::insert(Neo::ObjectHandle object)
+{
+	std::string name = object->getName().str();
+	if(name.empty())
+		return;
+
+	auto range = m_names.equal_range(name);
+	for(auto iter = range.first; iter != range.second; iter++)
+	{
+		if(iter->second == object)
+			return;
+	}
+
+	m_names.emplace(std::move(name), object);
+}
+
+void NameIndex::erase(const std::string& name, Neo::ObjectHandle object)
+{
+	// Only this object, others with the same name stay
+	auto range = m_names.equal_range(name);
+	for(auto iter = range.first; iter != range.second; iter++)
+	{
+		if(iter->second == object)
+		{
+			m_names.erase(iter);
+			return;
+		}
+	}
+}
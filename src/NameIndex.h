@@ -0,0 +1,48 @@
+#ifndef NEOEDITOR_NAMEINDEX_H
+#define NEOEDITOR_NAMEINDEX_H
+
+#include <Level.h>
+#include "LevelJournal.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Hash index from object names to handles for the editor level.
+ *
+ * Replaces most of the linear Level::find and Level::getUniqueName scans. The
+ * index follows the LevelJournal and is brought up to date lazily on every
+ * query, and rebuilt from the level once if the journal overflowed or the
+ * level was reset. Names can be shared by several objects. Found objects are
+ * checked against their current name, renames need to be journaled to be found
+ * under their new name.
+ */
+class NameIndex
+{
+public:
+	NameIndex(LevelJournal& journal);
+
+	void setLevel(std::shared_ptr<Neo::Level> level);
+
+	/// Returns an empty handle if no object has the given name, any of them if several have it
+	Neo::ObjectHandle find(const std::string& name);
+
+	/// Returns base if it is free, otherwise base with the next free number appended
+	std::string getUniqueName(const std::string& base);
+
+private:
+	void sync();
+	void rebuild();
+	void insert(Neo::ObjectHandle object);
+	void erase(const std::string& name, Neo::ObjectHandle object);
+
+	LevelJournal& m_journal;
+	uint64_t m_cursor = 0;
+	std::shared_ptr<Neo::Level> m_level;
+
+	std::unordered_multimap<std::string, Neo::ObjectHandle> m_names;
+	std::unordered_map<std::string, unsigned int> m_counters; // Last number used per prefix
+};
+
+#endif // NEOEDITOR_NAMEINDEX_H
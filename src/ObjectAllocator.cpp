@@ -0,0 +1,148 @@
+#include "ObjectAllocator.h"
+#include <Log.h>
+
+#include <limits>
+#include <memory>
+#include <string>
+
+void ObjectAllocator::setLevel(Neo::Level* level)
+{
+	m_level = level;
+	clear();
+}
+
+void ObjectAllocator::clear()
+{
+	m_free.clear();
+	m_needsScan = true;
+	m_generation++;
+}
+
+Neo::ObjectHandle ObjectAllocator::allocate()
+{
+	if(m_needsScan)
+	{
+		// Nothing can refer to dead objects of a freshly loaded level
+		auto root = m_level->getRoot();
+		for(auto& object : m_level->getObjects())
+		{
+			auto h = object.getSelf();
+			if(!(h == root) && isDead(h))
+				release(m_generation, h);
+		}
+
+		m_needsScan = false;
+	}
+
+	while(!m_free.empty())
+	{
+		auto object = m_free.back();
+		m_free.pop_back();
+
+		// Might have been brought back by a full scene undo
+		if(isDead(object))
+			return object;
+	}
+
+	return m_level->addObject("");
+}
+
+void ObjectAllocator::release(uint64_t generation, Neo::ObjectHandle object)
+{
+	// A full scene undo can load a live object into the slot of a dead one
+	if(generation != m_generation || object.empty() || !isDead(object))
+		return;
+
+	// Dead objects still know the subtree they had
+	object->getChildren().clear();
+	m_free.push_back(object);
+}
+
+ObjectAllocator::HandleMap ObjectAllocator::compact()
+{
+	struct Live
+	{
+		Neo::ObjectHandle object;
+		size_t parent; // Index into the live objects
+		std::string name;
+		bool active;
+		Neo::Vector3 position, scale;
+		Neo::Quaternion rotation;
+		std::vector<std::unique_ptr<Neo::Behavior>> behaviors;
+	};
+
+	const size_t NO_PARENT = std::numeric_limits<size_t>::max();
+	auto& level = *m_level;
+
+	// Collect everything reachable from the root, parents before their children
+	std::vector<Live> live;
+	std::vector<std::pair<Neo::ObjectHandle, size_t>> stack;
+	for(auto& child : level.getRoot()->getChildren())
+		stack.emplace_back(child, NO_PARENT);
+
+	while(!stack.empty())
+	{
+		auto object = stack.back().first;
+		auto parent = stack.back().second;
+		stack.pop_back();
+
+		if(isDead(object))
+			continue;
+
+		live.emplace_back();
+		auto& l = live.back();
+		l.object = object;
+		l.parent = parent;
+		l.name = object->getName().str();
+		l.active = object->isActive();
+		l.position = object->getPosition();
+		l.rotation = object->getRotation();
+		l.scale = object->getScale();
+		// The level begins them again with their new objects
+		for(auto& b : object->getBehaviors())
+			b->end();
+
+		l.behaviors = std::move(object->getBehaviors());
+		object->getBehaviors().clear();
+
+		const size_t index = live.size() - 1;
+		auto& children = object->getChildren();
+		for(auto iter = children.rbegin(); iter != children.rend(); iter++)
+			stack.emplace_back(*iter, index);
+	}
+
+	const size_t oldCount = level.getObjects().size();
+
+	// clearObjects also clears the current camera
+	auto* cam = level.getCurrentCamera();
+	level.clearObjects();
+	level.setCurrentCamera(cam);
+
+	HandleMap handles;
+	std::vector<Neo::ObjectHandle> created(live.size());
+	for(size_t i = 0; i < live.size(); i++)
+	{
+		auto& l = live[i];
+		auto object = level.addObject(l.name.c_str());
+
+		object->setParent(l.parent == NO_PARENT ? level.getRoot() : created[l.parent]);
+		object->setPosition(l.position);
+		object->setRotation(l.rotation);
+		object->setScale(l.scale);
+		object->updateMatrix();
+		object->setActive(l.active);
+
+		for(auto& b : l.behaviors)
+			object->addBehavior(std::move(b));
+
+		created[i] = object;
+		handles[l.object] = object;
+	}
+
+	m_free.clear();
+	m_needsScan = false;
+	m_generation++;
+
+	LOG_INFO("Compacted level from " << oldCount << " to " << level.getObjects().size() << " objects");
+	return handles;
+}
@@ -0,0 +1,63 @@
+#ifndef NEOEDITOR_OBJECTALLOCATOR_H
+#define NEOEDITOR_OBJECTALLOCATOR_H
+
+#include <Level.h>
+#include "ObjectHandleHash.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Hands out object slots for objects created in the editor.
+ *
+ * Deleted objects stay in the level as long as an undo step refers to them.
+ * Once that is not the case anymore they are released into a free list and
+ * reused, so creating objects does not need to scan the level for inactive ones.
+ * compact() removes dead objects from the level entirely.
+ */
+class ObjectAllocator
+{
+public:
+	typedef std::unordered_map<Neo::ObjectHandle, Neo::ObjectHandle, ObjectHandleHash> HandleMap;
+
+	/// The free list is built from the dead objects of the level with the next allocation
+	void setLevel(Neo::Level* level);
+
+	/// Forgets all free slots and rebuilds them with the next allocation, used when the level was reloaded behind our back
+	void clear();
+
+	/**
+	 * Changes whenever the objects of the level are replaced, i.e. with setLevel(),
+	 * clear() and compact(). Handles taken in an older generation must not be released.
+	 */
+	uint64_t getGeneration() const { return m_generation; }
+
+	Neo::ObjectHandle allocate();
+
+	/// Makes the slot available again, ignored if the handle is from an older generation or the object is alive
+	void release(uint64_t generation, Neo::ObjectHandle object);
+
+	/**
+	 * Rebuilds the level from the objects reachable from its root, dropping
+	 * all dead objects. Behaviors are ended and moved to the new objects,
+	 * the level needs to be initialized again afterwards.
+	 * All handles become invalid!
+	 *
+	 * @return Maps the old handles of live objects to their new ones.
+	 */
+	HandleMap compact();
+
+	static bool isDead(Neo::ObjectHandle object)
+	{
+		return !object->isActive() && object->getName().str()[0] == 0;
+	}
+
+private:
+	Neo::Level* m_level = nullptr;
+	std::vector<Neo::ObjectHandle> m_free;
+	bool m_needsScan = false;
+	uint64_t m_generation = 0;
+};
+
+#endif // NEOEDITOR_OBJECTALLOCATOR_H
@@ -0,0 +1,19 @@
+#ifndef NEOEDITOR_OBJECTHANDLEHASH_H
+#define NEOEDITOR_OBJECTHANDLEHASH_H
+
+#include <Object.h>
+#include <functional>
+
+/**
+ * Hashes object handles by their slot in the level so they can be used as
+ * keys of unordered containers, e.g. std::unordered_map<ObjectHandle, T, ObjectHandleHash>.
+ */
+struct ObjectHandleHash
+{
+	size_t operator()(const Neo::ObjectHandle& h) const
+	{
+		return std::hash<size_t>()(h.getIndex());
+	}
+};
+
+#endif // NEOEDITOR_OBJECTHANDLEHASH_H
@@ -0,0 +1,87 @@
+#include "ObjectSelection.h"
+
+#include <QTimer>
+#include <algorithm>
+
+ObjectSelection::ObjectSelection(QObject* parent):
+	QObject(parent)
+{
+
+}
+
+void ObjectSelection::set(const std::vector<Neo::ObjectHandle>& objects)
+{
+	m_objects.clear();
+	m_set.clear();
+	add(objects);
+
+	// Also notify when the selection became empty
+	notify();
+}
+
+bool ObjectSelection::add(Neo::ObjectHandle object)
+{
+	if(object.empty() || !m_set.insert(object).second)
+		return false;
+
+	m_objects.push_back(object);
+	notify();
+	return true;
+}
+
+bool ObjectSelection::add(const std::vector<Neo::ObjectHandle>& objects)
+{
+	const size_t oldSize = m_objects.size();
+	m_objects.reserve(m_objects.size() + objects.size());
+	for(auto& object : objects)
+	{
+		if(!object.empty() && m_set.insert(object).second)
+			m_objects.push_back(object);
+	}
+
+	if(m_objects.size() == oldSize)
+		return false;
+
+	notify();
+	return true;
+}
+
+bool ObjectSelection::remove(const std::vector<Neo::ObjectHandle>& objects)
+{
+	size_t removed = 0;
+	for(auto& object : objects)
+		removed += m_set.erase(object);
+
+	if(!removed)
+		return false;
+
+	// One pass over the selection no matter how many objects are removed
+	m_objects.erase(std::remove_if(m_objects.begin(), m_objects.end(), [this](const Neo::ObjectHandle& h) {
+		return m_set.count(h) == 0;
+	}), m_objects.end());
+
+	notify();
+	return true;
+}
+
+void ObjectSelection::clear()
+{
+	if(m_objects.empty())
+		return;
+
+	m_objects.clear();
+	m_set.clear();
+	notify();
+}
+
+void ObjectSelection::notify()
+{
+	if(m_notifyPending)
+		return;
+
+	m_notifyPending = true;
+	QTimer::singleShot(0, this, [this]() {
+		m_notifyPending = false;
+		emit changed();
+	});
+}
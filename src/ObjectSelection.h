@@ -0,0 +1,51 @@
+#ifndef NEOEDITOR_OBJECTSELECTION_H
+#define NEOEDITOR_OBJECTSELECTION_H
+
+#include <QObject>
+#include <Object.h>
+#include "ObjectHandleHash.h"
+
+#include <unordered_set>
+#include <vector>
+
+/**
+ * The set of selected objects, shared by the viewport and the level tree.
+ *
+ * Lookups are O(1) and the order of selection is kept, the first object is
+ * the one shown in the inspector. Any number of modifications in one event
+ * loop iteration result in a single changed() signal.
+ */
+class ObjectSelection : public QObject
+{
+	Q_OBJECT;
+public:
+	ObjectSelection(QObject* parent = nullptr);
+
+	const std::vector<Neo::ObjectHandle>& getObjects() const { return m_objects; }
+	bool contains(Neo::ObjectHandle object) const { return m_set.count(object) != 0; }
+
+	bool empty() const { return m_objects.empty(); }
+	size_t size() const { return m_objects.size(); }
+	Neo::ObjectHandle operator[](size_t i) const { return m_objects[i]; }
+	std::vector<Neo::ObjectHandle>::const_iterator begin() const { return m_objects.begin(); }
+	std::vector<Neo::ObjectHandle>::const_iterator end() const { return m_objects.end(); }
+
+	// The modifiers return if the selection actually changed
+	void set(const std::vector<Neo::ObjectHandle>& objects);
+	bool add(Neo::ObjectHandle object);
+	bool add(const std::vector<Neo::ObjectHandle>& objects);
+	bool remove(const std::vector<Neo::ObjectHandle>& objects);
+	void clear();
+
+signals:
+	void changed();
+
+private:
+	void notify();
+
+	std::vector<Neo::ObjectHandle> m_objects;
+	std::unordered_set<Neo::ObjectHandle, ObjectHandleHash> m_set;
+	bool m_notifyPending = false;
+};
+
+#endif // NEOEDITOR_OBJECTSELECTION_H
@@ -0,0 +1,131 @@
+#ifndef NEOEDITOR_OBJECTSTATE_H
+#define NEOEDITOR_OBJECTSTATE_H
+
+#include <Behavior.h>
+#include <Level.h>
+#include <Object.h>
+#include "LevelJournal.h"
+
+#include <string>
+#include <variant>
+#include <vector>
+
+/**
+ * The editable state of a single object: Transformation, name, hierarchy
+ * and the values of all behavior properties.
+ */
+struct ObjectState
+{
+	typedef std::variant<bool, int, unsigned int, float,
+				Neo::Vector2, Neo::Vector3, Neo::Vector4, std::string> Value;
+
+	struct Property
+	{
+		std::string behavior;
+		std::string name;
+		Value value;
+	};
+
+	Neo::ObjectHandle object;
+	Neo::ObjectHandle parent;
+	std::string name;
+	bool active = true;
+
+	Neo::Vector3 position, scale;
+	Neo::Quaternion rotation;
+
+	std::vector<Property> properties;
+
+	/// Appends the values of all properties of the behavior
+	static void captureProperties(Neo::Behavior& behavior, std::vector<Property>& properties)
+	{
+		for(auto* prop : behavior.getProperties())
+		{
+			Value value;
+			switch(prop->getType())
+			{
+			case Neo::BOOL: value = prop->get<bool>(); break;
+			case Neo::INTEGER: value = prop->get<int>(); break;
+			case Neo::UNSIGNED_INTEGER: value = prop->get<unsigned int>(); break;
+			case Neo::FLOAT: value = prop->get<float>(); break;
+			case Neo::VECTOR2: value = prop->get<Neo::Vector2>(); break;
+			case Neo::VECTOR3: value = prop->get<Neo::Vector3>(); break;
+			case Neo::VECTOR4:
+			case Neo::COLOR: value = prop->get<Neo::Vector4>(); break;
+			case Neo::PATH:
+			case Neo::STRING: value = prop->get<std::string>(); break;
+			default: continue;
+			}
+
+			properties.push_back({behavior.getName(), prop->getName(), std::move(value)});
+		}
+	}
+
+	/// Sets the property of the behavior, returns false if the behavior has no such property
+	static bool applyProperty(Neo::Behavior& behavior, const Property& p, Neo::Level& level)
+	{
+		for(auto* prop : behavior.getProperties())
+		{
+			if(prop->getName() != p.name)
+				continue;
+
+			std::visit([prop](const auto& v) { prop->set(v); }, p.value);
+			behavior.propertyChanged(prop, level);
+			return true;
+		}
+
+		return false;
+	}
+
+	void capture(Neo::ObjectHandle h)
+	{
+		object = h;
+		parent = h->getParent();
+		name = h->getName().str();
+		active = h->isActive();
+
+		position = h->getPosition();
+		rotation = h->getRotation();
+		scale = h->getScale();
+
+		properties.clear();
+		for(auto& behavior : h->getBehaviors())
+			captureProperties(*behavior, properties);
+	}
+
+	void apply(Neo::Level& level, LevelJournal& journal) const
+	{
+		if(!(object->getParent() == parent))
+		{
+			object->setParent(parent);
+			journal.record(LevelJournal::OBJECT_REPARENTED, object, parent);
+		}
+
+		if(object->getName().str() != name)
+		{
+			const std::string oldName = object->getName().str();
+			object->setName(name.c_str());
+			journal.record(LevelJournal::OBJECT_RENAMED, object, Neo::ObjectHandle(), oldName);
+		}
+
+		object->setActive(active);
+
+		object->setPosition(position);
+		object->setRotation(rotation);
+		object->setScale(scale);
+		object->updateMatrix();
+
+		object->makeSubtreeDirty();
+		object->updateChildMatrices();
+		journal.record(LevelJournal::OBJECT_TRANSFORMED, object);
+
+		for(auto& p : properties)
+		{
+			auto* behavior = object->getBehavior(p.behavior.c_str());
+			if(behavior && applyProperty(*behavior, p, level))
+				journal.record(LevelJournal::PROPERTY_CHANGED, object, Neo::ObjectHandle(), p.behavior + "/" + p.name);
+		}
+	}
+};
+
+#endif // NEOEDITOR_OBJECTSTATE_H
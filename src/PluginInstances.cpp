@@ -0,0 +1,88 @@
+#include "PluginInstances.h"
+
+#include <Behavior.h>
+#include <Log.h>
+
+#include <algorithm>
+#include <unordered_set>
+
+void PluginInstances::detach(Neo::Level& level, const std::vector<std::string>& behaviors)
+{
+	if(&level != m_level)
+		m_instances.clear();
+
+	m_level = &level;
+	std::unordered_set<std::string> names(behaviors.begin(), behaviors.end());
+
+	std::vector<Neo::ObjectHandle> stack = {level.getRoot()};
+	while(!stack.empty())
+	{
+		auto object = stack.back();
+		stack.pop_back();
+
+		auto& list = object->getBehaviors();
+		size_t index = 0;
+		for(auto iter = list.begin(); iter != list.end(); index++)
+		{
+			auto& behavior = *iter;
+			if(!names.count(behavior->getName()))
+			{
+				iter++;
+				continue;
+			}
+
+			Instance instance;
+			instance.object = object;
+			instance.index = index;
+			instance.behavior = behavior->getName();
+			ObjectState::captureProperties(*behavior, instance.properties);
+			m_instances.push_back(std::move(instance));
+
+			behavior->end();
+			iter = list.erase(iter);
+		}
+
+		for(auto& child : object->getChildren())
+			stack.push_back(child);
+	}
+
+	LOG_DEBUG("Detached " << m_instances.size() << " plugin behaviors");
+}
+
+std::vector<std::pair<Neo::ObjectHandle, Neo::Behavior*>> PluginInstances::attach(Neo::Level& level, LevelJournal& journal)
+{
+	std::vector<std::pair<Neo::ObjectHandle, Neo::Behavior*>> created;
+	if(&level != m_level)
+	{
+		m_instances.clear();
+		return created;
+	}
+
+	std::vector<Instance> missing;
+	for(auto& instance : m_instances)
+	{
+		if(!Neo::Behavior::isBehaviorRegistered(instance.behavior.c_str()))
+		{
+			LOG_WARNING("Behavior " << instance.behavior << " is not part of the plugin anymore");
+			missing.push_back(std::move(instance));
+			continue;
+		}
+
+		auto& object = instance.object;
+		auto* behavior = object->addBehavior(Neo::Behavior::create(instance.behavior.c_str()));
+
+		// Instances were detached in order, so putting them back in order restores the positions
+		auto& list = object->getBehaviors();
+		if(instance.index + 1 < list.size())
+			std::rotate(list.begin() + instance.index, list.end() - 1, list.end());
+
+		for(auto& p : instance.properties)
+			ObjectState::applyProperty(*behavior, p, level);
+
+		journal.record(LevelJournal::BEHAVIORS_CHANGED, object);
+		created.emplace_back(object, behavior);
+	}
+
+	m_instances = std::move(missing);
+	return created;
+}
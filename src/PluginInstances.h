@@ -0,0 +1,48 @@
+#ifndef NEOEDITOR_PLUGININSTANCES_H
+#define NEOEDITOR_PLUGININSTANCES_H
+
+#include <Level.h>
+#include "LevelJournal.h"
+#include "ObjectState.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Keeps the plugin behaviors of a level across a reload of the game plugin.
+ *
+ * detach() saves the properties of every instance of the given behaviors and
+ * removes them from their objects, so nothing references the old library
+ * when it is unloaded. attach() creates them again by name from the newly
+ * registered behaviors and restores the saved properties. Everything else in
+ * the level stays untouched and does not need to be re-initialized.
+ */
+class PluginInstances
+{
+	struct Instance
+	{
+		Neo::ObjectHandle object;
+		size_t index = 0; // Position in the behaviors of the object
+		std::string behavior;
+		std::vector<ObjectState::Property> properties;
+	};
+
+public:
+	void detach(Neo::Level& level, const std::vector<std::string>& behaviors);
+
+	/**
+	 * Re-creates the detached behaviors. Behaviors which are not registered
+	 * anymore are kept and tried again with the next attach(). Instances of
+	 * a level other than the one given to detach() are dropped.
+	 * @return The new behaviors with their objects, they still need to be begun.
+	 */
+	std::vector<std::pair<Neo::ObjectHandle, Neo::Behavior*>> attach(Neo::Level& level, LevelJournal& journal);
+
+	bool empty() const { return m_instances.empty(); }
+
+private:
+	std::vector<Instance> m_instances;
+	Neo::Level* m_level = nullptr; // The level the instances were detached from
+};
+
+#endif // NEOEDITOR_PLUGININSTANCES_H
@@ -3,23 +3,55 @@
 
 #include <QUndoStack>
 #include <BinaryScene.h>
+#include <Behavior.h>
+#include <Level.h>
+#include <Object.h>
 #include "platform/LevelWidget.h"
+#include "LevelJournal.h"
+#include "ObjectState.h"
+#include "ObjectHandleHash.h"
+#include "UndoStorage.h"
+#include "profiling/Trace.h"
 
-struct FullSceneEditCommand : public QUndoCommand
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Base for all commands which are created before an edit (setUndo) and
+ * completed after it (setRedo).
+ */
+struct EditCommand : public QUndoCommand
+{
+	virtual void setUndo() = 0;
+	virtual void setRedo() = 0;
+};
+
+/**
+ * Fallback for structural edits (adding/removing objects, behaviors etc.):
+ * Saves the whole level before and after the change.
+ */
+struct FullSceneEditCommand : public EditCommand
 {
 	FullSceneEditCommand(Neo::LevelWidget& wdg):
 		m_levelWidget(wdg)
 	{ }
 
-	void loadLevel(std::stringstream& ss)
+	void loadLevel(const UndoStorage::Snapshot& snapshot)
 	{
+		TRACE_SCOPE("Load undo snapshot");
 		auto& level = *m_levelWidget.getLevel();
 
 		// clearObjects also clears the current camera
 		auto* cam = level.getCurrentCamera();
 		level.clearObjects();
-		
+
 		// Load scene from buffer
+		std::stringstream ss(snapshot.data());
 		Neo::BinaryScene scene;
 		scene.load(level, ss);
 
@@ -27,11 +59,13 @@ struct FullSceneEditCommand : public QUndoCommand
 
 		// Re-initialize level!
 		m_levelWidget.setNeedsInit(true);
+		m_levelWidget.getJournal().reset();
+		m_levelWidget.getAllocator().clear();
 	}
 
 	void undo() override
 	{
-		loadLevel(m_undo);
+		loadLevel(*m_undo);
 	}
 
 	void redo() override
@@ -39,24 +73,316 @@ struct FullSceneEditCommand : public QUndoCommand
 		// Redo is being called always on creation
 		// so we need to ignore the first call!
 		if(m_redoCounter++ > 0)
-			loadLevel(m_redo);
+			loadLevel(*m_redo);
 	}
 
-	void setUndo()
+	void setUndo() override
 	{
-		Neo::BinaryScene scene;
-		scene.save(*m_levelWidget.getLevel(), m_undo);
+		m_undo = saveLevel();
 	}
 
-	void setRedo()
+	void setRedo() override
 	{
+		m_redo = saveLevel();
+	}
+
+	std::shared_ptr<UndoStorage::Snapshot> saveLevel()
+	{
+		TRACE_SCOPE("Save undo snapshot");
+		std::stringstream ss;
 		Neo::BinaryScene scene;
-		scene.save(*m_levelWidget.getLevel(), m_redo);
+		scene.save(*m_levelWidget.getLevel(), ss);
+		return UndoStorage::get().store(ss.str());
+	}
+
+	std::shared_ptr<UndoStorage::Snapshot> m_undo, m_redo;
+	Neo::LevelWidget& m_levelWidget;
+	int m_redoCounter = 0;
+};
+
+/**
+ * Records only the objects touched by an edit and restores them in place.
+ * Used for transformations, renames and property edits which do not change
+ * the structure of the level.
+ */
+struct ObjectEditCommand : public EditCommand
+{
+	enum { ID = 1 };
+
+	// Edits of the same property closer together than this are merged
+	static constexpr long long MERGE_WINDOW_MS = 1000;
+
+	/**
+	 * @param mergeKey Identifies the edited property. Consecutive commands
+	 * with the same key on the same objects are merged into one undo step.
+	 */
+	ObjectEditCommand(Neo::LevelWidget& wdg, const std::vector<Neo::ObjectHandle>& objects, const QString& mergeKey = QString()):
+		m_levelWidget(wdg),
+		m_objects(objects),
+		m_mergeKey(mergeKey)
+	{ }
+
+	int id() const override
+	{
+		return m_mergeKey.isEmpty() ? -1 : ID;
+	}
+
+	bool mergeWith(const QUndoCommand* other) override
+	{
+		auto* cmd = static_cast<const ObjectEditCommand*>(other);
+		if(cmd->m_mergeKey != m_mergeKey
+			|| cmd->m_objects != m_objects
+			|| cmd->m_timestamp - m_timestamp > MERGE_WINDOW_MS)
+			return false;
+
+		m_redo = cmd->m_redo;
+		m_timestamp = cmd->m_timestamp;
+		return true;
+	}
+
+	void undo() override
+	{
+		apply(m_undo);
+	}
+
+	void redo() override
+	{
+		// Redo is being called always on creation
+		// so we need to ignore the first call!
+		if(m_redoCounter++ > 0)
+			apply(m_redo);
+	}
+
+	void setUndo() override
+	{
+		capture(m_undo);
 	}
 
-	std::stringstream m_undo, m_redo;
+	void setRedo() override
+	{
+		capture(m_redo);
+
+		using namespace std::chrono;
+		m_timestamp = duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	void capture(std::vector<ObjectState>& states)
+	{
+		states.resize(m_objects.size());
+		for(size_t i = 0; i < m_objects.size(); i++)
+			states[i].capture(m_objects[i]);
+	}
+
+	void apply(const std::vector<ObjectState>& states)
+	{
+		auto& level = *m_levelWidget.getLevel();
+		for(auto& state : states)
+			state.apply(level, m_levelWidget.getJournal());
+	}
+
+	std::vector<ObjectState> m_undo, m_redo;
 	Neo::LevelWidget& m_levelWidget;
+	std::vector<Neo::ObjectHandle> m_objects;
+	QString m_mergeKey;
+	long long m_timestamp = 0;
 	int m_redoCounter = 0;
 };
 
+/**
+ * Deletes a set of objects including their subtrees in one batch.
+ *
+ * The children of every affected parent are compacted in a single pass and
+ * only the behaviors of the deleted objects are ended. The behaviors are kept
+ * alive by the command so undo can put them back without touching the rest
+ * of the level. Unlike the other commands, the deletion happens in the first redo.
+ */
+struct DeleteObjectsCommand : public QUndoCommand
+{
+	struct Entry
+	{
+		Neo::ObjectHandle object;
+		Neo::ObjectHandle parent; // Only set for the roots of the deleted subtrees
+		size_t index = 0; // Position in the children of the parent
+		std::string name;
+		bool active = true;
+		std::vector<std::unique_ptr<Neo::Behavior>> behaviors;
+	};
+
+	DeleteObjectsCommand(Neo::LevelWidget& wdg, const std::vector<Neo::ObjectHandle>& objects):
+		m_levelWidget(wdg),
+		m_generation(wdg.getAllocator().getGeneration())
+	{
+		std::unordered_set<Neo::ObjectHandle, ObjectHandleHash> selected(objects.begin(), objects.end());
+
+		// Objects without a selected ancestor are detached from their parents,
+		// everything below them goes with them.
+		for(auto& object : selected)
+		{
+			if(object.empty())
+				continue;
+
+			bool hasSelectedAncestor = false;
+			for(auto p = object->getParent(); !p.empty() && !hasSelectedAncestor; p = p->getParent())
+				hasSelectedAncestor = selected.count(p);
+
+			if(!hasSelectedAncestor)
+			{
+				m_entries.emplace_back();
+				m_entries.back().object = object;
+				m_entries.back().parent = object->getParent();
+			}
+		}
+
+		// Depth first over the subtrees, the roots come first
+		const size_t roots = m_entries.size();
+		for(size_t i = 0; i < roots; i++)
+		{
+			std::vector<Neo::ObjectHandle> stack(m_entries[i].object->getChildren().begin(), m_entries[i].object->getChildren().end());
+			while(!stack.empty())
+			{
+				auto object = stack.back();
+				stack.pop_back();
+
+				m_entries.emplace_back();
+				m_entries.back().object = object;
+
+				for(auto& child : object->getChildren())
+					stack.push_back(child);
+			}
+		}
+	}
+
+	~DeleteObjectsCommand()
+	{
+		// Nothing can bring the objects back anymore, their slots can be reused
+		if(m_deleted)
+		{
+			for(auto& e : m_entries)
+				m_levelWidget.getAllocator().release(m_generation, e.object);
+		}
+	}
+
+	void undo() override
+	{
+		restore();
+		m_deleted = false;
+	}
+
+	void redo() override
+	{
+		remove();
+		m_deleted = true;
+	}
+
+	// Groups the roots of the deleted subtrees by their parent
+	typedef std::unordered_map<Neo::ObjectHandle, std::vector<Entry*>, ObjectHandleHash> ParentMap;
+	ParentMap groupByParent()
+	{
+		ParentMap parents;
+		for(auto& e : m_entries)
+		{
+			if(!e.parent.empty())
+				parents[e.parent].push_back(&e);
+		}
+
+		return parents;
+	}
+
+	void remove()
+	{
+		auto& journal = m_levelWidget.getJournal();
+
+		for(auto& p : groupByParent())
+		{
+			std::unordered_map<Neo::ObjectHandle, Entry*, ObjectHandleHash> removed;
+			for(auto* e : p.second)
+				removed[e->object] = e;
+
+			// Compact the children in one pass instead of one removeChild per object
+			auto& children = p.first->getChildren();
+			size_t out = 0;
+			for(size_t i = 0; i < children.size(); i++)
+			{
+				auto iter = removed.find(children[i]);
+				if(iter != removed.end())
+				{
+					iter->second->index = i;
+					continue;
+				}
+
+				children[out++] = children[i];
+			}
+
+			children.resize(out);
+		}
+
+		for(auto& e : m_entries)
+		{
+			auto& object = e.object;
+			for(auto& b : object->getBehaviors())
+				b->end();
+
+			e.behaviors = std::move(object->getBehaviors());
+			object->getBehaviors().clear();
+
+			e.name = object->getName().str();
+			e.active = object->isActive();
+
+			object->setActive(false);
+			object->setName("");
+
+			journal.record(LevelJournal::OBJECT_REMOVED, object, e.parent.empty() ? object->getParent() : e.parent, e.name);
+		}
+
+		// The behaviors are destroyed with the command once it is evicted
+		m_levelWidget.forgetRemovedBehaviors();
+	}
+
+	void restore()
+	{
+		auto& journal = m_levelWidget.getJournal();
+
+		for(auto& p : groupByParent())
+		{
+			auto& entries = p.second;
+			std::sort(entries.begin(), entries.end(), [](const Entry* a, const Entry* b) { return a->index < b->index; });
+
+			// Merge the deleted objects back at their old positions
+			auto& children = p.first->getChildren();
+			std::vector<Neo::ObjectHandle> merged;
+			merged.reserve(children.size() + entries.size());
+
+			size_t next = 0;
+			for(auto* e : entries)
+			{
+				while(merged.size() < e->index && next < children.size())
+					merged.push_back(children[next++]);
+
+				merged.push_back(e->object);
+			}
+
+			merged.insert(merged.end(), children.begin() + next, children.end());
+			children.swap(merged);
+		}
+
+		for(auto& e : m_entries)
+		{
+			auto& object = e.object;
+			object->setName(e.name.c_str());
+			object->setActive(e.active);
+
+			for(auto& b : e.behaviors)
+				m_levelWidget.beginBehavior(object, object->addBehavior(std::move(b)));
+
+			e.behaviors.clear();
+			journal.record(LevelJournal::OBJECT_ADDED, object, object->getParent());
+		}
+	}
+
+	std::vector<Entry> m_entries;
+	Neo::LevelWidget& m_levelWidget;
+	uint64_t m_generation; // Of the allocator when the objects were deleted
+	bool m_deleted = false;
+};
+
 #endif
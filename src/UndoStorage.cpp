@@ -0,0 +1,300 @@
+#include "UndoStorage.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+
+#include <Log.h>
+#include <profiling/Trace.h>
+
+#include <array>
+
+namespace
+{
+
+// Chunk boundaries are found with a gear rolling hash so inserting or removing
+// data only changes the chunks around the edit instead of shifting all following ones.
+constexpr size_t MIN_CHUNK_SIZE = 16 * 1024;
+constexpr size_t MAX_CHUNK_SIZE = 256 * 1024;
+constexpr uint64_t CHUNK_MASK = (64 * 1024) - 1;
+
+constexpr std::array<uint64_t, 256> makeGearTable()
+{
+	std::array<uint64_t, 256> table = {};
+	uint64_t state = 0x9E3779B97F4A7C15ull;
+	for(auto& v : table)
+	{
+		// splitmix64
+		state += 0x9E3779B97F4A7C15ull;
+		uint64_t z = state;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		v = z ^ (z >> 31);
+	}
+	return table;
+}
+
+constexpr auto s_gear = makeGearTable();
+
+size_t nextChunkSize(const char* data, size_t size)
+{
+	if(size <= MIN_CHUNK_SIZE)
+		return size;
+
+	const size_t end = std::min(size, MAX_CHUNK_SIZE);
+	uint64_t hash = 0;
+	for(size_t i = 0; i < end; i++)
+	{
+		hash = (hash << 1) + s_gear[static_cast<unsigned char>(data[i])];
+		if(i >= MIN_CHUNK_SIZE && (hash & CHUNK_MASK) == 0)
+			return i + 1;
+	}
+
+	return end;
+}
+
+}
+
+UndoStorage::Chunk::~Chunk()
+{
+	std::lock_guard<std::mutex> lock(storage->m_mutex);
+	storage->release(this);
+}
+
+std::string UndoStorage::Snapshot::data() const
+{
+	m_ready.wait();
+
+	std::string result;
+	result.reserve(m_size);
+
+	for(auto& chunk : m_chunks)
+	{
+		// The chunk might be spilled concurrently, so take a (shallow) copy first
+		QByteArray compressed;
+		{
+			std::lock_guard<std::mutex> lock(chunk->storage->m_mutex);
+			if(chunk->mapped)
+				compressed = QByteArray::fromRawData(reinterpret_cast<const char*>(chunk->mapped), static_cast<int>(chunk->size));
+			else
+				compressed = chunk->data;
+		}
+
+		const auto raw = qUncompress(compressed);
+		result.append(raw.constData(), raw.size());
+	}
+
+	return result;
+}
+
+UndoStorage::~UndoStorage()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_queueMutex);
+		m_stop = true;
+	}
+
+	m_queueCondition.notify_all();
+	if(m_worker.joinable())
+		m_worker.join();
+
+	if(m_spillFile.isOpen())
+		m_spillFile.remove();
+}
+
+UndoStorage& UndoStorage::get()
+{
+	static UndoStorage s;
+	return s;
+}
+
+std::shared_ptr<UndoStorage::Snapshot> UndoStorage::store(std::string&& data)
+{
+	auto snapshot = std::make_shared<Snapshot>();
+	snapshot->m_size = data.size();
+
+	// Waiting snapshots count against the budget as well, so the worker
+	// spills early enough during a burst of big edits
+	m_memoryUsage += data.size();
+
+	auto task = std::make_shared<std::packaged_task<void()>>([this, snapshot, data = std::move(data)]() {
+		compress(*snapshot, data);
+	});
+
+	snapshot->m_ready = task->get_future().share();
+
+	{
+		std::lock_guard<std::mutex> lock(m_queueMutex);
+		if(!m_worker.joinable())
+			m_worker = std::thread(&UndoStorage::run, this);
+
+		m_queue.push_back([task]() { (*task)(); });
+	}
+
+	m_queueCondition.notify_one();
+	return snapshot;
+}
+
+void UndoStorage::run()
+{
+	Trace::get().setThreadName("Undo storage");
+	while(true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(m_queueMutex);
+			m_queueCondition.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+
+			if(m_queue.empty())
+				return;
+
+			task = std::move(m_queue.front());
+			m_queue.pop_front();
+		}
+
+		task();
+	}
+}
+
+void UndoStorage::compress(Snapshot& snapshot, const std::string& data)
+{
+	TRACE_SCOPE("Compress undo snapshot");
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		enforceBudget();
+	}
+
+	size_t offset = 0;
+	while(offset < data.size())
+	{
+		const char* begin = data.data() + offset;
+		const size_t size = nextChunkSize(begin, data.size() - offset);
+		offset += size;
+
+		const auto key = QCryptographicHash::hash(QByteArray::fromRawData(begin, static_cast<int>(size)), QCryptographicHash::Md5);
+
+		// Reuse the chunk if some other snapshot already contains it
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto existing = m_chunks.value(key).lock();
+			if(existing)
+			{
+				snapshot.m_chunks.push_back(existing);
+				continue;
+			}
+		}
+
+		auto chunk = std::make_shared<Chunk>();
+		chunk->storage = this;
+		chunk->key = key;
+		chunk->data = qCompress(reinterpret_cast<const uchar*>(begin), static_cast<int>(size));
+		chunk->size = chunk->data.size();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		chunk->sequence = m_sequence++;
+
+		m_chunks[key] = chunk;
+		m_residentChunks[chunk->sequence] = chunk.get();
+		m_memoryUsage += chunk->size;
+
+		snapshot.m_chunks.push_back(chunk);
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_memoryUsage -= data.size();
+	enforceBudget();
+
+	Trace::get().counter("Undo memory (MiB)", m_memoryUsage / (1024.0 * 1024.0));
+	Trace::get().counter("Undo disk (MiB)", m_diskUsage / (1024.0 * 1024.0));
+}
+
+void UndoStorage::setMemoryBudget(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_memoryBudget = bytes;
+	enforceBudget();
+}
+
+void UndoStorage::setSpillDirectory(const QString& dir)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_spillDirectory = dir;
+}
+
+void UndoStorage::release(Chunk* chunk)
+{
+	auto iter = m_chunks.find(chunk->key);
+	if(iter != m_chunks.end() && iter->expired())
+		m_chunks.erase(iter);
+
+	if(chunk->mapped)
+	{
+		m_spillFile.unmap(chunk->mapped);
+		m_diskUsage -= chunk->size;
+
+		// Start over once nothing references the spill file anymore
+		if(m_diskUsage == 0)
+			m_spillFile.remove();
+	}
+	else
+	{
+		m_residentChunks.erase(chunk->sequence);
+		m_memoryUsage -= chunk->size;
+	}
+}
+
+void UndoStorage::enforceBudget()
+{
+	while(m_memoryUsage > m_memoryBudget && !m_residentChunks.empty())
+	{
+		if(!spill(m_residentChunks.begin()->second))
+			return;
+	}
+}
+
+bool UndoStorage::openSpillFile()
+{
+	if(m_spillFile.isOpen())
+		return true;
+
+	const auto dir = m_spillDirectory.isEmpty() ? QDir::tempPath() : m_spillDirectory;
+	m_spillFile.setFileName(dir + QDir::separator() + ".undo-cache");
+	m_spillOffset = 0;
+
+	if(!m_spillFile.open(QIODevice::ReadWrite | QIODevice::Truncate))
+	{
+		LOG_ERROR("Could not open undo spill file: " << m_spillFile.fileName().toStdString());
+		return false;
+	}
+
+	return true;
+}
+
+bool UndoStorage::spill(Chunk* chunk)
+{
+	if(!openSpillFile())
+		return false;
+
+	if(!m_spillFile.seek(m_spillOffset)
+		|| m_spillFile.write(chunk->data) != chunk->size
+		|| !m_spillFile.flush())
+	{
+		LOG_ERROR("Could not write to undo spill file!");
+		return false;
+	}
+
+	chunk->mapped = m_spillFile.map(m_spillOffset, chunk->size);
+	if(!chunk->mapped)
+	{
+		LOG_ERROR("Could not map undo spill file!");
+		return false;
+	}
+
+	m_spillOffset += chunk->size;
+	m_residentChunks.erase(chunk->sequence);
+
+	m_memoryUsage -= chunk->size;
+	m_diskUsage += chunk->size;
+	chunk->data.clear();
+
+	return true;
+}
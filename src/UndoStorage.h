@@ -0,0 +1,117 @@
+#ifndef NEOEDITOR_UNDOSTORAGE_H
+#define NEOEDITOR_UNDOSTORAGE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Backing store for undo snapshots.
+ *
+ * Snapshots are split into content defined chunks which are compressed and
+ * shared between snapshots, so two consecutive snapshots of a big level only
+ * cost the chunks which actually differ. When the compressed chunks exceed the
+ * memory budget, the oldest ones are moved into a memory mapped spill file.
+ *
+ * Chunking and compression happen on a background thread, the snapshot data
+ * is only waited for when it is actually needed.
+ */
+class UndoStorage
+{
+	struct Chunk
+	{
+		UndoStorage* storage = nullptr;
+		QByteArray key; // Hash of the uncompressed data
+		QByteArray data; // Compressed data while in memory
+		uchar* mapped = nullptr; // Compressed data after being spilled
+		qint64 size = 0; // Compressed size
+		uint64_t sequence = 0;
+
+		~Chunk();
+	};
+
+public:
+	class Snapshot
+	{
+		friend class UndoStorage;
+		std::vector<std::shared_ptr<Chunk>> m_chunks;
+		std::shared_future<void> m_ready;
+		size_t m_size = 0;
+
+	public:
+		/// Blocks until the snapshot was processed by the storage
+		std::string data() const;
+		size_t size() const { return m_size; }
+
+		bool isReady() const
+		{
+			return m_ready.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		}
+	};
+
+	~UndoStorage();
+	static UndoStorage& get();
+
+	/// Returns immediately, the data is compressed in the background.
+	std::shared_ptr<Snapshot> store(std::string&& data);
+
+	void setMemoryBudget(size_t bytes);
+	size_t getMemoryBudget() const { return m_memoryBudget; }
+
+	/// Compressed bytes currently held in memory plus the uncompressed snapshots waiting for the worker
+	size_t getMemoryUsage() const { return m_memoryUsage; }
+
+	/// Compressed bytes currently spilled to disk
+	size_t getDiskUsage() const { return m_diskUsage; }
+
+	/// The directory the spill file is created in, usually the project directory.
+	/// Takes effect the next time the spill file is created.
+	void setSpillDirectory(const QString& dir);
+
+private:
+	UndoStorage() = default;
+
+	void compress(Snapshot& snapshot, const std::string& data);
+	void run();
+
+	// All of the following expect m_mutex to be locked
+	void release(Chunk* chunk);
+	void enforceBudget();
+	bool spill(Chunk* chunk);
+	bool openSpillFile();
+
+	std::mutex m_mutex;
+	QHash<QByteArray, std::weak_ptr<Chunk>> m_chunks;
+	std::map<uint64_t, Chunk*> m_residentChunks; // Sorted by age
+	uint64_t m_sequence = 0;
+
+	std::atomic<size_t> m_memoryBudget = 256 * 1024 * 1024;
+	std::atomic<size_t> m_memoryUsage = 0;
+	std::atomic<size_t> m_diskUsage = 0;
+
+	QString m_spillDirectory;
+	QFile m_spillFile;
+	qint64 m_spillOffset = 0;
+
+	// Background worker
+	std::thread m_worker;
+	std::mutex m_queueMutex;
+	std::condition_variable m_queueCondition;
+	std::deque<std::function<void()>> m_queue;
+	bool m_stop = false;
+};
+
+#endif // NEOEDITOR_UNDOSTORAGE_H
@@ -17,6 +17,21 @@ PreferencesDialog::PreferencesDialog(QWidget* parent, MainWindow::Configuration&
 	connect(ui->themeCombo, &QComboBox::currentTextChanged, [this](const QString& text) {
 		m_config.theme = text.toStdString();
 	});
+
+	ui->undoBudgetSpin->setValue(config.undoMemoryBudget);
+	connect(ui->undoBudgetSpin, QOverload<int>::of(&QSpinBox::valueChanged), [this](int value) {
+		m_config.undoMemoryBudget = value;
+	});
+
+	ui->compactOnSaveCheck->setChecked(config.compactOnSave);
+	connect(ui->compactOnSaveCheck, &QCheckBox::toggled, [this](bool value) {
+		m_config.compactOnSave = value;
+	});
+
+	ui->redrawCombo->setCurrentIndex(config.redrawOnDemand ? 1 : 0);
+	connect(ui->redrawCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), [this](int index) {
+		m_config.redrawOnDemand = (index == 1);
+	});
 }
 
 PreferencesDialog::~PreferencesDialog()
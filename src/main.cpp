@@ -2,6 +2,7 @@
 #include <QApplication>
 #include <QSurfaceFormat>
 
+#include <QCommandLineParser>
 #include <QFile>
 #include <QTextStream>
 #include <QDir>
@@ -15,6 +16,8 @@
 #include <glTFScene.h>
 
 #include <CoreDump.h>
+#include <profiling/Trace.h>
+#include <platform/HeadlessRunner.h>
 
 int main(int argc, char *argv[])
 {
@@ -34,8 +37,33 @@ int main(int argc, char *argv[])
 	//QApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
 	QApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
 	QApplication::setAttribute(Qt::AA_UseDesktopOpenGL);
+
+	// The game view uses the meshes and textures of the editor view, also when its dock floats
+	QApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
 	QApplication a(argc, argv);
 	
+	QCommandLineParser parser;
+	parser.addHelpOption();
+	QCommandLineOption traceOption("trace", "Captures a Chrome trace of the whole session into <file>.", "file");
+	parser.addOption(traceOption);
+
+	QCommandLineOption headlessOption("headless", "Renders <level> offscreen with an orbiting camera and writes frame statistics, no window is opened.");
+	QCommandLineOption levelOption("level", "The level to render in headless mode.", "file");
+	QCommandLineOption framesOption("frames", "Number of frames to measure in headless mode.", "count", "600");
+	QCommandLineOption sizeOption("size", "Framebuffer size in headless mode.", "WxH", "1280x720");
+	QCommandLineOption statsOption("stats", "Writes the headless frame statistics as JSON into <file> instead of stdout.", "file");
+	QCommandLineOption orbitOption("orbit-radius", "Distance of the headless camera to the level center, fits the level by default.", "radius");
+	QCommandLineOption cameraPathOption("camera-path", "Plays a camera path recorded in the editor instead of orbiting in headless mode.", "file");
+	parser.addOptions({headlessOption, levelOption, framesOption, sizeOption, statsOption, orbitOption, cameraPathOption});
+	parser.process(a);
+
+	// Relative paths are given from where the editor was started
+	const QDir workingDirectory = QDir::current();
+
+	Trace::get().setThreadName("GUI");
+	if(parser.isSet(traceOption))
+		Trace::get().start(workingDirectory.absoluteFilePath(parser.value(traceOption)));
+
 	QDir::setCurrent(a.applicationDirPath());
 
 #if 0
@@ -69,12 +97,42 @@ int main(int argc, char *argv[])
 
 	QSurfaceFormat::setDefaultFormat(format);
 
+	if(parser.isSet(headlessOption))
+	{
+		Neo::HeadlessRunner::Options options;
+		options.level = workingDirectory.absoluteFilePath(parser.value(levelOption));
+		options.frames = parser.value(framesOption).toUInt();
+
+		const auto size = parser.value(sizeOption).split('x');
+		if(size.size() == 2)
+			options.size = QSize(size[0].toInt(), size[1].toInt());
+
+		if(parser.isSet(statsOption))
+			options.statistics = workingDirectory.absoluteFilePath(parser.value(statsOption));
+		if(parser.isSet(orbitOption))
+			options.orbitRadius = parser.value(orbitOption).toFloat();
+		if(parser.isSet(cameraPathOption))
+			options.cameraPath = workingDirectory.absoluteFilePath(parser.value(cameraPathOption));
+
+		if(!parser.isSet(levelOption) || options.frames == 0 || options.size.isEmpty())
+		{
+			LOG_ERROR("Headless mode needs a --level, a frame count and a valid --size!");
+			return 1;
+		}
+
+		const int result = Neo::HeadlessRunner::run(options);
+		Trace::get().stop();
+		return result;
+	}
+
 	try
 	{	
 		MainWindow w;
 		w.show();
 
-		return a.exec();
+		const int result = a.exec();
+		Trace::get().stop();
+		return result;
 	}
 	catch(std::exception& e)
 	{
@@ -4,6 +4,8 @@
 
 #include "platform/OpenGLWidget.h"
 #include "project/Project.h"
+#include "LevelClone.h"
+#include "profiling/Trace.h"
 
 #include <dialogs/PublishDialog.h>
 #include <dialogs/PluginDialog.h>
@@ -12,8 +14,18 @@
 #include <Level.h>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QProgressBar>
 #include <QSettings>
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QSignalBlocker>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QTimer>
+
+#include <algorithm>
 
 #include <Log.h>
 #include <Object.h>
@@ -27,21 +39,33 @@ using namespace std;
 
 #define SUPPORTED_SCENE_FORMATS "*.*" // "*.jlv *.nlv *.dae *.3ds *.obj *.glb *.gltf *.blend *.fbx"
 
-static Neo::ObjectHandle createObject(Neo::Level& level, const char* newName)
+/// Writes results next to the recording they were produced from, so runs of different builds can be compared
+static QString writeResults(const QString& recording, const QString& suffix, const QByteArray& data)
 {
-	auto object = level.findInactive();
-	
-	if(object.empty())
-		object = level.addObject("");
+	QFile out(QFileInfo(recording).path() + "/" + QFileInfo(recording).completeBaseName() + suffix);
+	if(!out.open(QFile::WriteOnly | QFile::Truncate) || out.write(data) != data.size())
+	{
+		LOG_ERROR("Could not write results: " << out.fileName().toStdString());
+		return QString();
+	}
+
+	return out.fileName();
+}
+
+static Neo::ObjectHandle createObject(Neo::LevelWidget& editor, const char* newName)
+{
+	auto& level = *editor.getLevel();
+	auto object = editor.getAllocator().allocate();
 
 	object->getTransform().loadIdentity();
 	object->updateFromMatrix();
 	object->setActive(true);
 
-	auto name = level.getUniqueName(newName);
+	auto name = editor.getNameIndex().getUniqueName(newName);
 	object->setName(name.c_str());
 
 	object->setParent(level.getRoot());
+	editor.getJournal().record(LevelJournal::OBJECT_ADDED, object, level.getRoot());
 	
 	return object;
 }
@@ -49,7 +73,15 @@ static Neo::ObjectHandle createObject(Neo::Level& level, const char* newName)
 template<typename Fn>
 void MainWindow::executeUndoableAction(Fn fn)
 {
-	auto* undoAction = new FullSceneEditCommand(*ui->sceneEditor);
+	executeUndoableAction(new FullSceneEditCommand(*ui->sceneEditor), fn);
+}
+
+template<typename Fn>
+void MainWindow::executeUndoableAction(EditCommand* undoAction, Fn fn)
+{
+	// A property edit burst might still be running, it needs to be on the stack before this action
+	ui->objectWidget->finishEdit();
+
 	undoAction->setUndo();
 
 	try
@@ -95,9 +127,11 @@ MainWindow::MainWindow(QWidget *parent) :
 	auto level = std::make_shared<Neo::Level>();
 	ui->sceneEditor->setLevel(level);
 	ui->levelTree->setLevel(level);
+	ui->levelTree->setJournal(&ui->sceneEditor->getJournal());
 	ui->objectWidget->setLevel(level);
 
 	connect(this, &MainWindow::openLevel, [this](QString file) {
+		TRACE_SCOPE("Open level", file.toStdString());
 		try
 		{
 			LOG_INFO("Loading from file: " << file.toStdString());
@@ -115,6 +149,9 @@ MainWindow::MainWindow(QWidget *parent) :
 				QMessageBox::critical(this, tr("Error"), tr("Could not load scene file!"));
 				return;
 			}
+
+			// Everything was loaded at once, views need to start over
+			ui->sceneEditor->getJournal().reset();
 			
 			this->setWindowTitle(tr("Neo Editor") + " - " + file);
 			m_file = file.toStdString();
@@ -134,19 +171,26 @@ MainWindow::MainWindow(QWidget *parent) :
 	connect(this, &MainWindow::createProject, [this](QString file) {
 
 		LOG_INFO("Creating project in: " << file.toStdString());
-		m_currentProject = std::make_unique<Project>(std::move(Project::create(file.toUtf8().data())));
+
+		// The running build belongs to the old project
+		m_buildService.cancel();
+		setProject(std::make_unique<Project>(std::move(Project::create(file.toUtf8().data()))), file);
 	});
 	
 	connect(this, &MainWindow::openProject, [this](QString file) {
 		LOG_INFO("Creating project in: " << file.toStdString());
-		m_currentProject = std::make_unique<Project>(file.toUtf8().data());
-		m_currentProject->buildDebug();
-		emit behaviorsChanged();
+
+		m_buildService.cancel();
+		setProject(std::make_unique<Project>(file.toUtf8().data()), file);
 	});
 	
 	connect(this, &MainWindow::saveLevel, [this](QString file) {
+		TRACE_SCOPE("Save level", file.toStdString());
 		
 		LOG_INFO("Saving to file: " << file.toStdString());
+		if(m_config.compactOnSave)
+			compactLevel();
+
 		ui->sceneEditor->makePathsRelative(file.toStdString().substr(0, file.lastIndexOf('/') + 1));
 
 		if(!Neo::LevelLoader::save(*ui->sceneEditor->getLevel(), file.toUtf8().data()))
@@ -194,13 +238,11 @@ MainWindow::MainWindow(QWidget *parent) :
 					}
 						
 					Neo::Behavior* behavior = obj->addBehavior(Neo::Behavior::create(name.c_str()));
+					ui->sceneEditor->beginBehavior(obj, behavior);
+					ui->sceneEditor->getJournal().record(LevelJournal::BEHAVIORS_CHANGED, obj);
 				}
 				
 				ui->objectWidget->setObject(selection.front());
-
-
-				// To trigger re-init
-				ui->sceneEditor->setLevel(ui->sceneEditor->getLevel());
 				
 				emit levelChanged();
 				return true;
@@ -209,25 +251,57 @@ MainWindow::MainWindow(QWidget *parent) :
 	});
 	
 	connect(this, &MainWindow::levelChanged, ui->levelTree, &Neo::LevelTreeWidget::levelChangedSlot);
-	connect(ui->levelTree, &Neo::LevelTreeWidget::objectSelectionListChanged, ui->sceneEditor, &Neo::EditorWidget::setSelection);
-	connect(ui->sceneEditor, &Neo::EditorWidget::objectSelectionListChanged, ui->levelTree, &Neo::LevelTreeWidget::setSelectionList);
+
+	// Everything which changes what the viewport shows needs a new frame
+	connect(this, &MainWindow::levelChanged, [this]() { ui->sceneEditor->requestRedraw(); });
+	connect(&m_undoStack, &QUndoStack::indexChanged, [this]() { ui->sceneEditor->requestRedraw(); });
+	connect(ui->objectWidget, &Neo::ObjectWidget::objectChanged, [this]() { ui->sceneEditor->requestRedraw(); });
+
+	// The editor keeps drawing continuously while the game runs
+	connect(ui->gamePlayer, &Neo::GameWidget::playingChanged, [this](bool playing) {
+		ui->sceneEditor->setAnimating(ui->gamePlayer, playing);
+	});
+
+	connect(ui->gamePlayer, &Neo::GameWidget::playingChanged, ui->actionPause_Game, &QAction::setEnabled);
+	connect(ui->gamePlayer, &Neo::GameWidget::pausedChanged, ui->actionStep_Frame, &QAction::setEnabled);
+	connect(ui->gamePlayer, &Neo::GameWidget::pausedChanged, [this](bool paused) {
+		QSignalBlocker blocker(ui->actionPause_Game);
+		ui->actionPause_Game->setChecked(paused);
+	});
+	connect(ui->actionPause_Game, &QAction::toggled, ui->gamePlayer, &Neo::GameWidget::pauseGame);
+	connect(ui->actionStep_Frame, &QAction::triggered, ui->gamePlayer, &Neo::GameWidget::stepFrame);
+
+	ui->behaviorProfiler->setProfiler(&ui->gamePlayer->getBehaviorProfiler());
+	ui->levelTree->setObjectSelection(&ui->sceneEditor->getSelectionModel());
 	connect(ui->sceneEditor, &Neo::EditorWidget::objectChanged, ui->objectWidget, &Neo::ObjectWidget::updateObject);
 
 	connect(ui->sceneEditor, &Neo::EditorWidget::beginUndoableChange, this, &MainWindow::beginUndoableChangeSlot);
 	connect(ui->sceneEditor, &Neo::EditorWidget::endUndoableChange, this, &MainWindow::endUndoableChangeSlot);
 
-	connect(ui->objectWidget, &Neo::ObjectWidget::beginUndoableChange, this, &MainWindow::beginUndoableChangeSlot);
-	connect(ui->objectWidget, &Neo::ObjectWidget::endUndoableChange, this, &MainWindow::endUndoableChangeSlot);
+	connect(ui->objectWidget, &Neo::ObjectWidget::beginUndoableChange, [this](Neo::ObjectHandle object, QString property) {
+		beginUndoableObjectChange({object}, property);
+	});
+	connect(ui->objectWidget, &Neo::ObjectWidget::endUndoableChange, [this](Neo::ObjectHandle object, QString property) {
+		// Only record the end result instead of every value of the burst, like the gizmo
+		auto& journal = ui->sceneEditor->getJournal();
+		if(property.startsWith("Transform/"))
+			journal.record(LevelJournal::OBJECT_TRANSFORMED, object);
+		else
+			journal.record(LevelJournal::PROPERTY_CHANGED, object, Neo::ObjectHandle(), property.toStdString());
+
+		endUndoableChangeSlot();
+	});
 
-	connect(ui->objectWidget, &Neo::ObjectWidget::requestNameChange, [this, level](Neo::ObjectHandle h, QString name) {
+	connect(ui->objectWidget, &Neo::ObjectWidget::requestNameChange, [this](Neo::ObjectHandle h, QString name) {
 		if(name.isEmpty())
 		{
 			QMessageBox::critical(this, tr("Rename"), tr("Could not rename object: Name is empty!"));
 			return;
 		}
 		
-		auto nameData = name.toUtf8().data();
-		auto find = level->find(nameData);
+		const auto nameUtf8 = name.toUtf8();
+		const char* nameData = nameUtf8.data();
+		auto find = ui->sceneEditor->getNameIndex().find(nameData);
 		
 		if(find == h)
 			return;
@@ -237,8 +311,10 @@ MainWindow::MainWindow(QWidget *parent) :
 			return;
 		}
 		
-		executeUndoableAction([&]() {
+		executeUndoableAction(new ObjectEditCommand(*ui->sceneEditor, {h}), [&]() {
+			const std::string oldName = h->getName().str();
 			h->setName(nameData);
+			ui->sceneEditor->getJournal().record(LevelJournal::OBJECT_RENAMED, h, Neo::ObjectHandle(), oldName);
 			return true;
 		});
 		
@@ -248,32 +324,29 @@ MainWindow::MainWindow(QWidget *parent) :
 	
 	connect(ui->actionEmpty, &QAction::triggered, createUndoableAction([this]() {
 		
-		createObject(*ui->sceneEditor->getLevel(), "Object");
-		
-		// To trigger re-init
-		ui->sceneEditor->setLevel(ui->sceneEditor->getLevel());
+		auto obj = createObject(*ui->sceneEditor, "Object");
+		ui->sceneEditor->beginObject(obj);
+
 		emit levelChanged();
 		return true;
 	}));
 	
 	connect(ui->actionCamera, &QAction::triggered, createUndoableAction([this]() {
 		
-		auto cam = createObject(*ui->sceneEditor->getLevel(), "Camera");
+		auto cam = createObject(*ui->sceneEditor, "Camera");
 		cam->addBehavior<Neo::CameraBehavior>();
-		
-		// To trigger re-init
-		ui->sceneEditor->setLevel(ui->sceneEditor->getLevel());
+		ui->sceneEditor->beginObject(cam);
+
 		emit levelChanged();
 		return true;
 	}));
 	
 	connect(ui->actionLight, &QAction::triggered, createUndoableAction([this]() {
 		
-		auto obj = createObject(*ui->sceneEditor->getLevel(), "Light");
+		auto obj = createObject(*ui->sceneEditor, "Light");
 		obj->addBehavior<Neo::LightBehavior>();
-		
-		// To trigger re-init
-		ui->sceneEditor->setLevel(ui->sceneEditor->getLevel());
+		ui->sceneEditor->beginObject(obj);
+
 		emit levelChanged();
 		return true;
 	}));
@@ -292,82 +365,114 @@ MainWindow::MainWindow(QWidget *parent) :
 			return false;
 		}
 		
-		auto obj = createObject(*level, "Sound");
+		auto obj = createObject(*ui->sceneEditor, "Sound");
 		obj->addBehavior(std::make_unique<Neo::SoundBehavior>(sound));
-		
-		// To trigger re-init
-		ui->sceneEditor->setNeedsInit(true);
+		ui->sceneEditor->beginObject(obj);
+
 		emit levelChanged();
 		return true;
 	}));
 	
-	connect(ui->actionDelete_Object, &QAction::triggered, createUndoableAction([this]() {
+	connect(ui->actionDelete_Object, &QAction::triggered, [this]() {
+		// Commit a running property edit while the objects are still alive
+		ui->objectWidget->finishEdit();
+
 		auto& selection = ui->sceneEditor->getSelection();
-		
-		for(auto k : selection)
-		{
-			k->getBehaviors().clear();
-			k->setActive(false);
-			k->setName("");
-			
-			auto parent = k->getParent();
-			if(!parent.empty())
-				parent->removeChild(k);
-		}
-		
-		ui->sceneEditor->setSelection({});
-		
-		// To trigger re-init
-		ui->sceneEditor->setNeedsInit(true);
+		if(selection.empty())
+			return;
+
+		// Deletes on push
+		m_undoStack.push(new DeleteObjectsCommand(*ui->sceneEditor, selection));
+
+		ui->sceneEditor->clearSelection();
 		emit levelChanged();
-		return true;
-	}));
+	});
+
+	connect(ui->actionCompact_Level, &QAction::triggered, this, &MainWindow::compactLevel);
+	connect(ui->actionCapture_Trace, &QAction::toggled, this, &MainWindow::captureTrace);
+	ui->actionCapture_Trace->setChecked(Trace::get().isRunning());
+
+	connect(ui->actionRecord_Camera_Path, &QAction::toggled, this, &MainWindow::recordCameraPath);
+	connect(ui->actionPlay_Timedemo, &QAction::triggered, this, &MainWindow::playTimedemo);
+	connect(ui->actionRecord_Game_Input, &QAction::toggled, this, &MainWindow::recordGameInput);
+	connect(ui->actionPlay_Game_Timedemo, &QAction::triggered, this, &MainWindow::playGameTimedemo);
 	
 	connect(ui->actionPlay, &QAction::triggered, [this]() {
 		
-		try
+		if(ui->gamePlayer->isPlaying())
 		{
-			if(ui->gamePlayer->isPlaying())
-			{
-				emit behaviorsChanged();
-
-				auto* game = ui->gamePlayer->getGame();
-				// if(m_currentProject != nullptr)
-				//	delete game;
+			emit behaviorsChanged();
 
-				ui->gamePlayer->stopGame();
-				return;
-			}
+			auto* game = ui->gamePlayer->getGame();
+			// if(m_currentProject != nullptr)
+			//	delete game;
 
-			Neo::LevelGameState* game = nullptr;
-			if(m_currentProject != nullptr)
-			{
-				m_currentProject->buildDebug();
-				game = m_currentProject->getGameState();
-			}
-			else
-			{
-				game = new Neo::LevelGameState();
-			}
-				
-			// Load scene into buffer and and load into the game
-			// This ensures all behaviors are loaded correctly
-			// TODO Shallow copy so only objects are duplicated but not assets!
-			{
-				std::stringstream buffer;
-				ui->sceneEditor->getLevel()->serialize(buffer);
-				game->getLevel().deserialize(buffer);
-			}
-			
-			ui->gamePlayer->playGame(game);
-			
-			emit behaviorsChanged();
-			emit playGame();
+			ui->gamePlayer->stopGame();
+			m_playSource.reset();
+			return;
 		}
-		catch(std::exception& e)
+
+		if(m_currentProject == nullptr)
 		{
-			QMessageBox::critical(this, tr("Error"), tr("Error playing game: ") + e.what());
+			startGame(new Neo::LevelGameState());
+			return;
 		}
+
+		// Start playing once the plugin is up to date, the UI keeps running meanwhile
+		const bool started = m_currentProject->buildDebug(m_buildService, [this](bool success) {
+			auto* game = (m_currentProject ? m_currentProject->getGameState() : nullptr);
+			if(!success || !game)
+			{
+				QMessageBox::critical(this, tr("Error"), tr("The game plugin could not be loaded!"));
+				return;
+			}
+
+			startGame(game);
+		});
+
+		if(!started)
+			statusBar()->showMessage(tr("A build is already running"), 3000);
+	});
+
+	connect(ui->actionCancel_Build, &QAction::triggered, &m_buildService, &BuildService::cancel);
+
+	// Build progress and diagnostics
+	m_buildProgress = new QProgressBar;
+	m_buildProgress->setMaximumWidth(200);
+	m_buildProgress->setRange(0, 100);
+	m_buildProgress->hide();
+	statusBar()->addPermanentWidget(m_buildProgress);
+
+	connect(&m_buildService, &BuildService::started, [this]() {
+		ui->buildIssues->clear();
+		ui->actionCancel_Build->setEnabled(true);
+		m_buildProgress->setValue(0);
+		m_buildProgress->show();
+	});
+
+	connect(&m_buildService, &BuildService::stepStarted, [this](QString description) {
+		statusBar()->showMessage(description);
+	});
+
+	connect(&m_buildService, &BuildService::progress, m_buildProgress, &QProgressBar::setValue);
+
+	connect(&m_buildService, &BuildService::issueFound, [this](BuildIssue issue) {
+		static const char* severities[] = {QT_TR_NOOP("Error"), QT_TR_NOOP("Warning"), QT_TR_NOOP("Note")};
+		auto* item = new QTreeWidgetItem(ui->buildIssues, QStringList()
+						<< tr(severities[issue.severity])
+						<< issue.file + ":" + QString::number(issue.line) + ":" + QString::number(issue.column)
+						<< issue.message);
+		item->setToolTip(2, issue.message);
+	});
+
+	connect(&m_buildService, &BuildService::finished, [this](bool success) {
+		ui->actionCancel_Build->setEnabled(false);
+		m_buildProgress->hide();
+		statusBar()->showMessage(success ? tr("Build finished") : tr("Build failed"), 5000);
+
+		const auto& issues = m_buildService.getIssues();
+		if(std::any_of(issues.begin(), issues.end(), [](const BuildIssue& i) { return i.severity == BuildIssue::ISSUE_ERROR; }))
+			ui->buildDock->raise();
 	});
 
 	connect(ui->actionLoad_Skybox, &QAction::triggered, [this]() {
@@ -384,9 +489,8 @@ MainWindow::MainWindow(QWidget *parent) :
 		}
 
 		skybox->setTextureBase(path.toStdString() + "/");
+		ui->sceneEditor->beginCameraBehavior(skybox);
 
-		// To trigger re-init
-		ui->sceneEditor->setNeedsInit(true);
 		emit levelChanged();
 	});
 
@@ -438,9 +542,226 @@ MainWindow::MainWindow(QWidget *parent) :
 
 MainWindow::~MainWindow()
 {
+	// Undo commands refer to the editor widget
+	m_undoStack.clear();
 	delete ui;
 }
 
+void MainWindow::setProject(std::unique_ptr<Project> project, const QString& directory)
+{
+	m_currentProject = std::move(project);
+	UndoStorage::get().setSpillDirectory(directory);
+
+	// Plugin behaviors in the editor level survive rebuilds of the plugin
+	m_currentProject->setReloadCallbacks([this](const std::vector<std::string>& behaviors) {
+		m_reloadTimer.start();
+
+		// The running game uses the old library
+		if(ui->gamePlayer->isPlaying())
+		{
+			ui->gamePlayer->stopGame();
+			m_playSource.reset();
+		}
+
+		// Deleted objects kept for undo own their behaviors
+		bool ownsBehaviors = false;
+		for(int i = 0; i < m_undoStack.count() && !ownsBehaviors; i++)
+			ownsBehaviors = dynamic_cast<const DeleteObjectsCommand*>(m_undoStack.command(i));
+
+		if(ownsBehaviors)
+		{
+			LOG_WARNING("Clearing the undo history, it refers to the old game plugin");
+			m_undoStack.clear();
+		}
+
+		ui->objectWidget->finishEdit();
+		ui->objectWidget->clear();
+
+		m_pluginInstances.detach(*ui->sceneEditor->getLevel(), behaviors);
+		ui->sceneEditor->forgetRemovedBehaviors();
+	},
+	[this]() {
+		auto behaviors = m_pluginInstances.attach(*ui->sceneEditor->getLevel(), ui->sceneEditor->getJournal());
+		for(auto& p : behaviors)
+			ui->sceneEditor->beginBehavior(p.first, p.second);
+
+		auto& selection = ui->sceneEditor->getSelection();
+		if(!selection.empty())
+			ui->objectWidget->setObject(selection.front());
+
+		if(m_reloadTimer.isValid())
+			LOG_INFO("Hot reloaded " << behaviors.size() << " behaviors in " << m_reloadTimer.elapsed() << "ms");
+
+		m_reloadTimer.invalidate();
+		emit levelChanged();
+	});
+
+	m_currentProject->buildDebug(m_buildService, [this](bool) {
+		emit behaviorsChanged();
+	});
+}
+
+void MainWindow::captureTrace(bool enabled)
+{
+	auto& trace = Trace::get();
+	if(enabled == trace.isRunning())
+		return;
+
+	if(!enabled)
+	{
+		if(trace.stop())
+			statusBar()->showMessage(tr("Trace written to %1").arg(trace.getFile()), 5000);
+		return;
+	}
+
+	const auto file = QFileDialog::getSaveFileName(this, tr("Save Trace"), QDir::homePath() + "/neo-editor-trace.json", tr("Chrome Trace (*.json)"));
+	if(file.isEmpty() || !trace.start(file))
+	{
+		QSignalBlocker blocker(ui->actionCapture_Trace);
+		ui->actionCapture_Trace->setChecked(false);
+	}
+}
+
+void MainWindow::recordCameraPath(bool enabled)
+{
+	auto* editor = ui->sceneEditor;
+	ui->actionPlay_Timedemo->setEnabled(!enabled);
+
+	if(enabled)
+	{
+		editor->startRecordingCameraPath();
+		statusBar()->showMessage(tr("Recording camera path"));
+		return;
+	}
+
+	statusBar()->clearMessage();
+	const auto path = editor->stopRecordingCameraPath();
+	if(path.empty())
+		return;
+
+	const auto file = QFileDialog::getSaveFileName(this, tr("Save Camera Path"), ".", tr("Camera Path (*.json)"));
+	if(!file.isEmpty() && !path.save(file))
+		QMessageBox::critical(this, tr("Error"), tr("Could not save camera path!"));
+}
+
+void MainWindow::playTimedemo()
+{
+	const auto file = QFileDialog::getOpenFileName(this, tr("Play Timedemo"), ".", tr("Camera Path (*.json)"));
+	if(file.isEmpty())
+		return;
+
+	Neo::CameraPath path;
+	if(!path.load(file))
+	{
+		QMessageBox::critical(this, tr("Error"), tr("Could not load camera path!"));
+		return;
+	}
+
+	ui->actionRecord_Camera_Path->setEnabled(false);
+	ui->actionPlay_Timedemo->setEnabled(false);
+	statusBar()->showMessage(tr("Playing timedemo"));
+
+	ui->sceneEditor->playCameraPath(path, [this, file](const TimedemoStatistics& statistics) {
+		ui->actionRecord_Camera_Path->setEnabled(true);
+		ui->actionPlay_Timedemo->setEnabled(true);
+
+		const auto summary = statistics.getFrameTimes().summarize();
+		LOG_INFO("Timedemo: " << summary.frames << " frames, min " << summary.min << "ms, mean " << summary.mean
+				<< "ms, max " << summary.max << "ms, p50 " << summary.p50 << "ms, p95 " << summary.p95
+				<< "ms, p99 " << summary.p99 << "ms");
+
+		auto json = statistics.toJson();
+		json["level"] = QString::fromStdString(m_file);
+		json["cameraPath"] = file;
+
+		const auto results = writeResults(file, ".timedemo.json", QJsonDocument(json).toJson());
+		if(!results.isEmpty())
+			statusBar()->showMessage(tr("Timedemo: %1 ms mean, %2 ms p99, written to %3")
+				.arg(summary.mean).arg(summary.p99).arg(results), 10000);
+		else
+			statusBar()->clearMessage();
+	});
+}
+
+void MainWindow::recordGameInput(bool enabled)
+{
+	auto* game = ui->gamePlayer;
+	ui->actionPlay_Game_Timedemo->setEnabled(!enabled);
+
+	if(enabled)
+	{
+		// Recordings start with a fresh game, stop through the play action so everything is cleaned up
+		if(game->isPlaying())
+			ui->actionPlay->trigger();
+
+		game->startRecordingInput();
+		ui->actionPlay->trigger();
+		statusBar()->showMessage(tr("Recording game input"));
+		return;
+	}
+
+	statusBar()->clearMessage();
+	const auto recording = game->stopRecordingInput();
+	if(recording.getFrameCount() == 0)
+		return;
+
+	const auto file = QFileDialog::getSaveFileName(this, tr("Save Input Recording"), ".", tr("Input Recording (*.json)"));
+	if(!file.isEmpty() && !recording.save(file))
+		QMessageBox::critical(this, tr("Error"), tr("Could not save input recording!"));
+}
+
+void MainWindow::playGameTimedemo()
+{
+	const auto file = QFileDialog::getOpenFileName(this, tr("Play Game Timedemo"), ".", tr("Input Recording (*.json)"));
+	if(file.isEmpty())
+		return;
+
+	Neo::InputRecording recording;
+	if(!recording.load(file))
+	{
+		QMessageBox::critical(this, tr("Error"), tr("Could not load input recording!"));
+		return;
+	}
+
+	if(ui->gamePlayer->isPlaying())
+		ui->actionPlay->trigger();
+
+	ui->actionRecord_Game_Input->setEnabled(false);
+	ui->actionPlay_Game_Timedemo->setEnabled(false);
+	statusBar()->showMessage(tr("Playing game timedemo"));
+
+	ui->gamePlayer->playTimedemo(recording, [this, file](const Neo::GameWidget::PlayStatistics& statistics) {
+		ui->actionRecord_Game_Input->setEnabled(true);
+		ui->actionPlay_Game_Timedemo->setEnabled(true);
+
+		const auto update = statistics.update.summarize();
+		const auto draw = statistics.draw.summarize();
+		LOG_INFO("Game timedemo: " << update.frames << " frames, update mean " << update.mean << "ms, p99 " << update.p99
+				<< "ms, draw mean " << draw.mean << "ms, p99 " << draw.p99 << "ms");
+
+		auto json = statistics.toJson();
+		json["level"] = QString::fromStdString(m_file);
+		json["inputRecording"] = file;
+
+		const auto results = writeResults(file, ".game-timedemo.json", QJsonDocument(json).toJson());
+		writeResults(file, ".game-timedemo.csv", statistics.toCsv().toUtf8());
+
+		if(!results.isEmpty())
+			statusBar()->showMessage(tr("Game timedemo: %1 ms update, %2 ms draw on average, written to %3")
+				.arg(update.mean).arg(draw.mean).arg(results), 10000);
+		else
+			statusBar()->clearMessage();
+
+		// Called while the game draws, stop once the frame is done
+		QTimer::singleShot(0, this, [this]() {
+			if(ui->gamePlayer->isPlaying())
+				ui->actionPlay->trigger();
+		});
+	});
+
+	ui->actionPlay->trigger();
+}
+
 Neo::Level& MainWindow::getEditorLevel()
 {
 	return *ui->sceneEditor->getLevel();
@@ -481,8 +802,11 @@ void MainWindow::resetView()
 	splitDockWidget(ui->sceneDock, ui->objectDock, Qt::Orientation::Vertical);
 
 	tabifyDockWidget(ui->editorDock, ui->gameDock);
+	tabifyDockWidget(ui->consoleDock, ui->buildDock);
+	tabifyDockWidget(ui->consoleDock, ui->profilerDock);
 
 	ui->editorDock->raise();
+	ui->consoleDock->raise();
 	
 	// Because resize does not work...
 	ui->sceneDock->setMaximumWidth(0.15*width());
@@ -510,15 +834,29 @@ void MainWindow::resizeEvent(QResizeEvent* e)
 }
 
 void MainWindow::beginUndoableChangeSlot()
+{
+	// A property edit burst might still be running, commit it first
+	ui->objectWidget->finishEdit();
+
+	// Changes emitted by the editor always affect the current selection
+	beginUndoableObjectChange(ui->sceneEditor->getSelection());
+}
+
+void MainWindow::beginUndoableObjectChange(const std::vector<Neo::ObjectHandle>& objects, const QString& mergeKey)
 {
 	// Delete undo command if it is set, which means that a previous begin has had no end
 	// following it, thus it is incomplete.
 	delete m_currentUndoCommand;
-		
-	auto* fse = new FullSceneEditCommand(*ui->sceneEditor);
-	fse->setUndo();
 
-	m_currentUndoCommand = fse;
+	EditCommand* cmd = nullptr;
+	if(objects.empty() || objects.front().empty())
+		cmd = new FullSceneEditCommand(*ui->sceneEditor);
+	else
+		cmd = new ObjectEditCommand(*ui->sceneEditor, objects, mergeKey);
+
+	cmd->setUndo();
+
+	m_currentUndoCommand = cmd;
 	LOG_DEBUG("Undo change");
 }
 
@@ -528,9 +866,8 @@ void MainWindow::endUndoableChangeSlot()
 	if(!m_currentUndoCommand)
 		return;
 
-	auto* fse = static_cast<FullSceneEditCommand*>(m_currentUndoCommand);
-	fse->setRedo();
-	m_undoStack.push(fse);
+	m_currentUndoCommand->setRedo();
+	m_undoStack.push(m_currentUndoCommand);
 
 	m_currentUndoCommand = nullptr;
 	LOG_DEBUG("Redo change");
@@ -538,6 +875,8 @@ void MainWindow::endUndoableChangeSlot()
 
 void MainWindow::undoSlot()
 {
+	// Commit a running property edit so it can be undone as well
+	ui->objectWidget->finishEdit();
 	ui->sceneEditor->clearSelection();
 	ui->objectWidget->clear();
 
@@ -547,6 +886,7 @@ void MainWindow::undoSlot()
 
 void MainWindow::redoSlot()
 {
+	ui->objectWidget->finishEdit();
 	ui->sceneEditor->clearSelection();
 	ui->objectWidget->clear();
 	
@@ -554,6 +894,71 @@ void MainWindow::redoSlot()
 	emit levelChanged();
 }
 
+void MainWindow::startGame(Neo::LevelGameState* game)
+{
+	try
+	{
+		// Only duplicate objects and behaviors, assets are shared with the editor level
+		auto level = ui->sceneEditor->getLevel();
+		try
+		{
+			cloneLevel(*level, game->getLevel());
+		}
+		catch(std::exception& e)
+		{
+			LOG_WARNING("Could not clone level, falling back to serialization: " << e.what());
+
+			// Load scene into buffer and and load into the game
+			// This ensures all behaviors are loaded correctly
+			std::stringstream buffer;
+			level->serialize(buffer);
+
+			game->getLevel().clearObjects();
+			game->getLevel().deserialize(buffer);
+		}
+
+		// Keep the shared assets alive even if another level is opened while playing
+		m_playSource = level;
+		
+		ui->gamePlayer->playGame(game);
+		
+		emit behaviorsChanged();
+		emit playGame();
+	}
+	catch(std::exception& e)
+	{
+		QMessageBox::critical(this, tr("Error"), tr("Error playing game: ") + e.what());
+	}
+}
+
+void MainWindow::compactLevel()
+{
+	ui->objectWidget->finishEdit();
+
+	// Undo steps refer to the old handles. Clear them first so
+	// deleted objects are released before the level is rebuilt.
+	delete m_currentUndoCommand;
+	m_currentUndoCommand = nullptr;
+	m_undoStack.clear();
+
+	const auto oldSelection = ui->sceneEditor->getSelection();
+	auto handles = ui->sceneEditor->getAllocator().compact();
+
+	std::vector<Neo::ObjectHandle> selection;
+	for(auto& object : oldSelection)
+	{
+		auto iter = handles.find(object);
+		if(iter != handles.end())
+			selection.push_back(iter->second);
+	}
+
+	ui->sceneEditor->setNeedsInit(true);
+	ui->sceneEditor->getJournal().reset();
+	ui->sceneEditor->setSelection(selection);
+
+	emit levelChanged();
+}
+
 void MainWindow::openLevelSlot()
 {
 	auto file = QFileDialog::getOpenFileName(this, tr("Open Level"), ".", tr("All Supported (" SUPPORTED_SCENE_FORMATS ");;Neo Level (*.nlv);;Collada DAE (*.dae)"));
@@ -612,8 +1017,10 @@ void MainWindow::importScene(bool asLink)
 	auto name = file.toStdString();
 	name = name.substr(name.find_last_of('/') + 1);
 	
-	level->makeNameUnique(name);
+	name = ui->sceneEditor->getNameIndex().getUniqueName(name);
 	
+	// Everything from here on is new and needs to be started
+	const size_t firstNewObject = level->getObjects().size();
 	auto obj = level->addObject(name.c_str());
 	auto root = level->getRoot();
 	
@@ -641,8 +1048,14 @@ void MainWindow::importScene(bool asLink)
 		return true;
 	});
 
-	// To trigger re-init
-	ui->sceneEditor->setLevel(level);
+	auto& objects = level->getObjects();
+	for(size_t i = firstNewObject; i < objects.size(); i++)
+	{
+		auto object = objects[i].getSelf();
+		ui->sceneEditor->beginObject(object);
+		ui->sceneEditor->getJournal().record(LevelJournal::OBJECT_ADDED, object, object->getParent());
+	}
+
 	emit levelChanged();
 }
 
@@ -744,6 +1157,8 @@ static void applyTheme(const std::string& name, QWidget* w)
 void MainWindow::applyConfiguration()
 {
 	applyTheme(m_config.theme, this);
+	UndoStorage::get().setMemoryBudget(static_cast<size_t>(m_config.undoMemoryBudget) * 1024 * 1024);
+	ui->sceneEditor->setRedrawPolicy(m_config.redrawOnDemand ? Neo::REDRAW_ON_DEMAND : Neo::REDRAW_CONTINUOUS);
 }
 
 void MainWindow::Configuration::write(QSettings& settings)
@@ -751,6 +1166,9 @@ void MainWindow::Configuration::write(QSettings& settings)
 	settings.setValue("language", language.c_str());
 	settings.setValue("inputMethod", inputMethod.c_str());
 	settings.setValue("theme", theme.c_str());
+	settings.setValue("undoMemoryBudget", undoMemoryBudget);
+	settings.setValue("compactOnSave", compactOnSave);
+	settings.setValue("redrawOnDemand", redrawOnDemand);
 
 	settings.beginWriteArray("pluginDirectories", pluginDirectories.size());
 	for(size_t i = 0; i < pluginDirectories.size(); i++)
@@ -766,6 +1184,9 @@ void MainWindow::Configuration::read(QSettings& settings)
 	language = settings.value("language").toString().toStdString();
 	inputMethod = settings.value("inputMethod").toString().toStdString();
 	theme = settings.value("theme").toString().toStdString();
+	undoMemoryBudget = settings.value("undoMemoryBudget", undoMemoryBudget).toUInt();
+	compactOnSave = settings.value("compactOnSave", compactOnSave).toBool();
+	redrawOnDemand = settings.value("redrawOnDemand", redrawOnDemand).toBool();
 
 	settings.beginReadArray("pluginDirectories");
 	for(size_t i = 0; i < pluginDirectories.size(); i++)
@@ -1,6 +1,7 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include <QElapsedTimer>
 #include <QMainWindow>
 #include <QProcess>
 #include <QUndoStack>
@@ -8,12 +9,14 @@
 #include <memory>
 
 #include <ConsoleStream.h>
+#include <project/BuildService.h>
 #include <project/Project.h>
 #include <plugins/PluginHost.h>
 
 #include <behaviors/CameraBehavior.h>
 #include <Level.h>
 
+#include "PluginInstances.h"
 #include "UndoActions.h"
 
 namespace Ui 
@@ -24,9 +27,11 @@ class MainWindow;
 namespace Neo
 {
 class EditorWidget;
+class LevelGameState;
 }
 
 class QSettings;
+class QProgressBar;
 
 class MainWindow : public QMainWindow
 {
@@ -47,6 +52,11 @@ public:
 	template<typename Fn>
 	void executeUndoableAction(Fn fn);
 
+	template<typename Fn>
+	void executeUndoableAction(EditCommand* cmd, Fn fn);
+
+	void beginUndoableObjectChange(const std::vector<Neo::ObjectHandle>& objects, const QString& mergeKey = QString());
+
 	template<typename Fn>
 	auto createUndoableAction(Fn fn);
 
@@ -60,6 +70,9 @@ public:
 		std::string language = "en";
 		std::string inputMethod = "";
 		std::string theme = "Native";
+		unsigned int undoMemoryBudget = 256; // In MiB
+		bool compactOnSave = false; // Removes deleted objects before saving, clears the undo history!
+		bool redrawOnDemand = true; // Only redraw the editor viewport when something changed
 		std::vector<std::string> pluginDirectories;
 
 		void write(QSettings& settings);
@@ -99,6 +112,27 @@ public slots:
 	void undoSlot();
 	void redoSlot();
 
+	/// Removes deleted objects from the level, clears the undo history
+	void compactLevel();
+
+	/// Copies the editor level into the game and starts playing
+	void startGame(Neo::LevelGameState* game);
+
+	/// Starts a trace capture into a file chosen by the user or stops and writes it
+	void captureTrace(bool enabled);
+
+	/// Starts recording the viewport camera or stops and saves the path
+	void recordCameraPath(bool enabled);
+
+	/// Replays a camera path chosen by the user and writes the statistics next to it
+	void playTimedemo();
+
+	/// Restarts the game and records its input or stops and saves the recording
+	void recordGameInput(bool enabled);
+
+	/// Restarts the game with an input recording chosen by the user and writes the statistics next to it
+	void playGameTimedemo();
+
 	void beginUndoableChangeSlot();
 	void endUndoableChangeSlot();
 
@@ -114,16 +148,30 @@ public slots:
 	void resetView();
 
 private:
+	/// Makes the project current and builds its game plugin in the background
+	void setProject(std::unique_ptr<Project> project, const QString& directory);
+
 	Ui::MainWindow *ui;
 	ConsoleStream m_consoleStream;
 	std::unique_ptr<Project> m_currentProject;
 
+	// Declared after the project so it is destroyed first, builds refer to the project
+	BuildService m_buildService;
+	QProgressBar* m_buildProgress = nullptr;
+
+	// Plugin behaviors of the editor level while the plugin is reloaded
+	PluginInstances m_pluginInstances;
+	QElapsedTimer m_reloadTimer;
+
 	// Undo stack
 	QUndoStack m_undoStack;
 
 	// This is used when undo commands are created using signals
-	QUndoCommand* m_currentUndoCommand = nullptr;
+	EditCommand* m_currentUndoCommand = nullptr;
 	
+	// The level the running game shares its assets with
+	std::shared_ptr<Neo::Level> m_playSource;
+
 	std::string m_file; // The file that is currently being edited
 	bool m_readOnly = false; // If the file is loaded as read-only (e.g. for DAE files)
 
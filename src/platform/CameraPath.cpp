@@ -0,0 +1,74 @@
+#include "CameraPath.h"
+
+#include <Log.h>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+using namespace Neo;
+
+void CameraPath::record(Object& camera)
+{
+	m_frames.push_back({camera.getPosition(), camera.getRotation().getEulerAngles()});
+}
+
+void CameraPath::apply(size_t frame, Object& camera) const
+{
+	auto& f = m_frames[frame];
+	camera.setPosition(f.position);
+	camera.setRotation(Quaternion(f.rotation.x, f.rotation.y, f.rotation.z));
+	camera.updateMatrix();
+}
+
+bool CameraPath::save(const QString& file) const
+{
+	QJsonArray frames;
+	for(auto& f : m_frames)
+		frames.append(QJsonArray({f.position.x, f.position.y, f.position.z, f.rotation.x, f.rotation.y, f.rotation.z}));
+
+	QJsonObject json;
+	json["frames"] = frames;
+
+	QFile out(file);
+	const auto data = QJsonDocument(json).toJson(QJsonDocument::Compact);
+	if(!out.open(QFile::WriteOnly | QFile::Truncate) || out.write(data) != data.size())
+	{
+		LOG_ERROR("Could not write camera path: " << file.toStdString());
+		return false;
+	}
+
+	return true;
+}
+
+bool CameraPath::load(const QString& file)
+{
+	QFile in(file);
+	if(!in.open(QFile::ReadOnly))
+	{
+		LOG_ERROR("Could not open camera path: " << file.toStdString());
+		return false;
+	}
+
+	const auto frames = QJsonDocument::fromJson(in.readAll()).object()["frames"].toArray();
+
+	std::vector<Frame> result;
+	result.reserve(frames.size());
+	for(const auto& value : frames)
+	{
+		const auto f = value.toArray();
+		if(f.size() != 6)
+		{
+			LOG_ERROR("Invalid camera path: " << file.toStdString());
+			return false;
+		}
+
+		result.push_back({
+			Vector3(f[0].toDouble(), f[1].toDouble(), f[2].toDouble()),
+			Vector3(f[3].toDouble(), f[4].toDouble(), f[5].toDouble())});
+	}
+
+	m_frames = std::move(result);
+	return !m_frames.empty();
+}
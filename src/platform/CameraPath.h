@@ -0,0 +1,47 @@
+#ifndef NEO_CAMERAPATH_H
+#define NEO_CAMERAPATH_H
+
+#include <Object.h>
+#include <QString>
+
+#include <vector>
+
+namespace Neo
+{
+
+/**
+ * The transformation of the editor camera for every frame of a recording.
+ *
+ * Played back one recorded frame per rendered frame, so runs are identical
+ * regardless of how fast the frames were recorded or are drawn.
+ * Stored as JSON with one [x, y, z, pitch, roll, yaw] entry per frame.
+ */
+class CameraPath
+{
+public:
+	struct Frame
+	{
+		Vector3 position;
+		Vector3 rotation; ///< Euler angles in degrees
+	};
+
+	void clear() { m_frames.clear(); }
+	bool empty() const { return m_frames.empty(); }
+	size_t size() const { return m_frames.size(); }
+
+	/// Appends the current transformation of the camera
+	void record(Object& camera);
+
+	/// Moves the camera to the given frame
+	void apply(size_t frame, Object& camera) const;
+
+	bool save(const QString& file) const;
+	bool load(const QString& file);
+
+private:
+	std::vector<Frame> m_frames;
+};
+
+}
+
+#endif // NEO_CAMERAPATH_H
@@ -3,6 +3,8 @@
 #include <Platform.h>
 
 #include <Log.h>
+#include <UndoStorage.h>
+#include <profiling/Profiler.h>
 
 #include <imgui.h>
 #include "imgui_impl_opengl3.h"
@@ -11,6 +13,7 @@
 
 #include <QApplication>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QDesktopWidget>
 #include <QOpenGLContext>
 
@@ -19,7 +22,7 @@ using namespace Neo;
 EditorWidget::EditorWidget(QWidget* parent):
 	LevelWidget(parent)
 {
-
+	connect(&m_selection, &ObjectSelection::changed, [this]() { requestRedraw(); });
 }
 
 void EditorWidget::updateDPI()
@@ -64,6 +67,13 @@ void EditorWidget::initializeGL()
 	render->createTexture(m_objectTextures[2]);
 
 	glDisable(GL_BLEND);
+
+	m_frameTimer.create();
+	connect(context(), &QOpenGLContext::aboutToBeDestroyed, [this]() {
+		makeCurrent();
+		m_frameTimer.destroy();
+		doneCurrent();
+	});
 }
 
 void EditorWidget::resizeGL(int w, int h)
@@ -100,13 +110,43 @@ void EditorWidget::updateImGuiInput()
 	io.MouseDown[2] = mouse.isKeyDown(MOUSE_BUTTON_MIDDLE);
 }
 
+// Renders only the draw lists of the frame matching the filter, keeps their order
+template<typename Fn>
+static void renderDrawLists(ImDrawData* data, Fn filter)
+{
+	ImVector<ImDrawList*> lists;
+	for(int i = 0; i < data->CmdListsCount; i++)
+	{
+		if(filter(data->CmdLists[i]))
+			lists.push_back(data->CmdLists[i]);
+	}
+
+	if(lists.empty())
+		return;
+
+	ImDrawData subset = *data;
+	subset.CmdLists = lists.Data;
+	subset.CmdListsCount = lists.Size;
+	ImGui_ImplOpenGL3_RenderDrawData(&subset);
+}
+
 void EditorWidget::paintGL()
 {
+#ifdef NEO_PROFILER
+	// Collects the previous frame
+	Profiler::get().endFrame();
+#endif
+	PROFILE_SCOPE("Frame");
+
 	endFrame();
 	
 	updateDPI();
 
 	beginFrame();
+	m_frameTimer.beginFrame();
+
+	QElapsedTimer cpuTimer;
+	cpuTimer.start();
 
 	// Because in the init method, no defaultFramebufferObject is bound.
 	getRenderer()->setBackbuffer((void*) defaultFramebufferObject());
@@ -118,43 +158,35 @@ void EditorWidget::paintGL()
 
 	// Saved here so we can query it when drawing lights etc.
 	bool triggerSelect = input.getMouse().onKeyDown(MOUSE_BUTTON_LEFT);
-	if(triggerSelect && !ImGuizmo::IsOver())
 	{
-		auto& camera = getCamera();
+		PROFILE_SCOPE("Input");
+		if(triggerSelect && !ImGuizmo::IsOver())
+		{
+			auto& camera = getCamera();
 
-		Vector3 origin = camera.getParent()->getPosition();
-		Vector3 direction = camera.getUnProjectedPoint(Vector3(mousepos.x*m_dpiScale, (height() - mousepos.y)*m_dpiScale, 1));
-		direction = (direction - origin).getNormalized();
+			Vector3 origin = camera.getParent()->getPosition();
+			Vector3 direction = camera.getUnProjectedPoint(Vector3(mousepos.x*m_dpiScale, (height() - mousepos.y)*m_dpiScale, 1));
+			direction = (direction - origin).getNormalized();
 
-		Vector3 hit;
-		if(getLevel()->castRay(origin, direction, 1000000.0f, &hit, &selectedObject))
-		{
-			if(input.isKeyDown(KEY_LSHIFT) || input.isKeyDown(KEY_RSHIFT))
+			Vector3 hit;
+			if(getLevel()->castRay(origin, direction, 1000000.0f, &hit, &selectedObject))
 			{
-				m_selection.push_back(selectedObject);
+				if(input.isKeyDown(KEY_LSHIFT) || input.isKeyDown(KEY_RSHIFT))
+					m_selection.add(selectedObject);
+				else
+					m_selection.set({selectedObject});
 			}
-			else
+			else if(!input.isKeyDown(KEY_LSHIFT) && !input.isKeyDown(KEY_RSHIFT))
 			{
 				m_selection.clear();
-				m_selection.push_back(selectedObject);
 			}
-
-			emit objectSelectionChanged(selectedObject);
-			emit objectSelectionListChanged(m_selection);
-		}
-		else if(!input.isKeyDown(KEY_LSHIFT) && !input.isKeyDown(KEY_RSHIFT))
-		{
-			m_selection.clear();
-
-			emit objectSelectionChanged(ObjectHandle());
-			emit objectSelectionListChanged(m_selection);
 		}
-	}
 
-	// FIXME: HACK!
-	input.flush();
+		// FIXME: HACK!
+		input.flush();
 
-	updateImGuiInput();
+		updateImGuiInput();
+	}
 	
 	Matrix4x4 id;
 	id.loadIdentity();
@@ -183,7 +215,10 @@ void EditorWidget::paintGL()
 						| ImGuiWindowFlags_NoSavedSettings
 						| ImGuiWindowFlags_NoFocusOnAppearing
 						| ImGuiWindowFlags_NoBringToFrontOnFocus);
+	// Icons are rendered separately so their GPU time can be measured
+	ImDrawList* iconDrawList = ImGui::GetWindowDrawList();
 	{
+		PROFILE_SCOPE("Icons");
 		auto lvl = getLevel();
 		for(auto& obj : lvl->getObjects())
 		{
@@ -212,16 +247,14 @@ void EditorWidget::paintGL()
 					&& mousepos.x >= p.x && mousepos.x < (p.x + iconSize)
 					&& mousepos.y >= p.y && mousepos.y < (p.y + iconSize))
 				{
+					// The icon wins over the object hit by the ray
 					if(!selectedObject.empty())
-						m_selection.pop_back();
+						m_selection.remove({selectedObject});
 
 					if(!input.isKeyDown(KEY_LSHIFT) && !input.isKeyDown(KEY_RSHIFT))
-						m_selection.clear();
-
-					m_selection.push_back(obj.getSelf());
-
-					emit objectSelectionChanged(obj.getSelf());
-					emit objectSelectionListChanged(m_selection);
+						m_selection.set({obj.getSelf()});
+					else
+						m_selection.add(obj.getSelf());
 				}
 			}
 		}
@@ -233,14 +266,80 @@ void EditorWidget::paintGL()
 	ImGui::Text("Draw Calls: %d\n"
 				"Triangles:  %d\n"
 				"Frametime:  %f\n"
-				"FPS:        %f",
+				"FPS:        %f\n"
+				"CPU:        %.2f ms\n"
+				"Undo:       %.2f MiB (%.2f MiB on disk)",
 				
 				getRenderer()->getDrawCallCount(),
 				getRenderer()->getFaceCount(),
 				getDeltaTime(),
-				1000.0f/getDeltaTime());
+				1000.0f/getDeltaTime(),
+				m_cpuTime,
+				UndoStorage::get().getMemoryUsage() / (1024.0f * 1024.0f),
+				UndoStorage::get().getDiskUsage() / (1024.0f * 1024.0f));
+
+	if(m_frameTimer.hasGpuTimes())
+	{
+		ImGui::Text("GPU:        %.2f ms\n"
+					"  Level:    %.2f ms\n"
+					"  Icons:    %.2f ms\n"
+					"  ImGui:    %.2f ms",
+					m_frameTimer.getGpuFrameTime(),
+					m_frameTimer.getGpuTime(FrameTimer::PASS_LEVEL),
+					m_frameTimer.getGpuTime(FrameTimer::PASS_ICONS),
+					m_frameTimer.getGpuTime(FrameTimer::PASS_IMGUI));
+	}
+	else
+	{
+		ImGui::Text("GPU:        n/a");
+	}
 	ImGui::End();
+
+#ifdef NEO_PROFILER
+	Profiler::get().drawOverlay();
+#endif
 	
+	updateGizmo();
+
+	m_frameTimer.beginPass(FrameTimer::PASS_LEVEL);
+	LevelWidget::paintGL();
+	m_frameTimer.endPass(FrameTimer::PASS_LEVEL);
+
+	{
+		PROFILE_SCOPE("ImGui::Render");
+		ImGui::Render();
+
+		// The icon window is behind everything else, so drawing it first keeps the order
+		m_frameTimer.beginPass(FrameTimer::PASS_ICONS);
+		renderDrawLists(ImGui::GetDrawData(), [iconDrawList](ImDrawList* list) { return list == iconDrawList; });
+		m_frameTimer.endPass(FrameTimer::PASS_ICONS);
+
+		m_frameTimer.beginPass(FrameTimer::PASS_IMGUI);
+		renderDrawLists(ImGui::GetDrawData(), [iconDrawList](ImDrawList* list) { return list != iconDrawList; });
+		m_frameTimer.endPass(FrameTimer::PASS_IMGUI);
+	}
+
+	// Clear alpha buffer so we don't blend with the desktop wallpaper
+	#if 0
+	glColorMask(false, false, false, true);
+	glClearColor(0, 0, 0, 1);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glColorMask(true, true, true, true);
+	#endif
+
+	// Instead of glFinish, only wait if the GPU is more than a frame behind
+	m_frameTimer.endFrame();
+	m_cpuTime = cpuTimer.nsecsElapsed() / 1000000.0f;
+
+	// FIXME Hack!
+	// Reset delta of scroll value
+	input.getMouse().setScrollValue(0);
+}
+
+void EditorWidget::updateGizmo()
+{
+	PROFILE_SCOPE("ImGuizmo");
+
 	ImGuizmo::BeginFrame();
 
 	// Defined in CMake
@@ -379,6 +478,11 @@ void EditorWidget::paintGL()
 		if(m_gizmoIsEditing && !ImGuizmo::IsUsing() && m_gizmoMoved)
 		{
 			m_gizmoMoved = false;
+
+			// Only record the end result instead of every frame of the drag
+			for(auto& object : m_selection)
+				getJournal().record(LevelJournal::OBJECT_TRANSFORMED, object);
+
 			emit endUndoableChange();
 		}
 		else if(!m_gizmoIsEditing && ImGuizmo::IsUsing())
@@ -396,30 +500,11 @@ void EditorWidget::paintGL()
 		m_gizmoMoved = false;
 		m_gizmoIsEditing = false;
 	}
-
-	LevelWidget::paintGL();
-	ImGui::Render();
-	
-	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-
-	// Clear alpha buffer so we don't blend with the desktop wallpaper
-	#if 0
-	glColorMask(false, false, false, true);
-	glClearColor(0, 0, 0, 1);
-	glClear(GL_COLOR_BUFFER_BIT);
-	glColorMask(true, true, true, true);
-	#endif
-
-	glFinish();
-
-	// FIXME Hack!
-	// Reset delta of scroll value
-	input.getMouse().setScrollValue(0);
 }
 
 void EditorWidget::setSelection(const std::vector<ObjectHandle>& selection)
 {
-	m_selection = selection;
+	m_selection.set(selection);
 }
 
 Vector3 EditorWidget::selectionCenter()
@@ -2,6 +2,8 @@
 #define NEO_EDITORWIDGET_H
 
 #include "LevelWidget.h"
+#include "FrameTimer.h"
+#include <ObjectSelection.h>
 #include <Texture.h>
 
 namespace Neo 
@@ -21,12 +23,11 @@ public:
 	EditorWidget(QWidget* parent);
 
 	void setMode(EDITOR_MODE mode) { m_mode = mode; }
-	const std::vector<ObjectHandle>& getSelection() const { return m_selection; }
-	void clearSelection()
-	{
-		m_selection.clear();
-		emit objectSelectionChanged(ObjectHandle());
-	}
+	const std::vector<ObjectHandle>& getSelection() const { return m_selection.getObjects(); }
+	void clearSelection() { m_selection.clear(); }
+
+	/// The selection model shared with the other views
+	ObjectSelection& getSelectionModel() { return m_selection; }
 
 	void makePathsRelative(const std::string& dir);
 
@@ -39,8 +40,6 @@ public slots:
 	void setSelection(const std::vector<ObjectHandle>& selection);
 	
 signals:
-	void objectSelectionChanged(ObjectHandle);
-	void objectSelectionListChanged(const std::vector<ObjectHandle>&);
 	void objectChanged(ObjectHandle);
 	
 	void beginUndoableChange();
@@ -49,15 +48,19 @@ signals:
 private:
 	void updateDPI();
 	void updateImGuiInput();
+	void updateGizmo();
 	Vector3 selectionCenter();
 
 	float m_scaledWidth = 0, m_scaledHeight = 0, m_dpiScale = 1;
-	std::vector<ObjectHandle> m_selection;
+	ObjectSelection m_selection;
 	EDITOR_MODE m_mode = EDITOR_TRANSLATE;
 
 	bool m_gizmoIsEditing = false;
 	bool m_gizmoMoved = false;
 
+	FrameTimer m_frameTimer;
+	float m_cpuTime = 0.0f; // Time spent in paintGL in ms
+
 	// Contains the textures belonging to the camera/light/etc. objects
 	Texture* m_objectTextures[3];
 };
@@ -0,0 +1,128 @@
+#include "FrameTimer.h"
+
+#include <Log.h>
+
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+
+using namespace Neo;
+
+void FrameTimer::create()
+{
+	auto* context = QOpenGLContext::currentContext();
+	m_timerQueries = !context->isOpenGLES()
+			&& (context->format().version() >= qMakePair(3, 3) || context->hasExtension("GL_ARB_timer_query"));
+
+	for(auto& frame : m_frames)
+	{
+		for(auto& query : frame.queries)
+		{
+			query = std::make_unique<QOpenGLTimerQuery>();
+			if(m_timerQueries && !query->create())
+				m_timerQueries = false;
+		}
+	}
+
+	if(!m_timerQueries)
+		LOG_WARNING("GPU timer queries are not supported, only CPU times are available");
+
+	m_created = true;
+}
+
+void FrameTimer::destroy()
+{
+	if(!m_created)
+		return;
+
+	auto* gl = QOpenGLContext::currentContext()->extraFunctions();
+	for(auto& frame : m_frames)
+	{
+		if(frame.fence)
+			gl->glDeleteSync(frame.fence);
+
+		frame.fence = nullptr;
+		for(auto& query : frame.queries)
+			query.reset();
+	}
+
+	m_created = false;
+}
+
+void FrameTimer::beginFrame()
+{
+	if(!m_created)
+		return;
+
+	auto* gl = QOpenGLContext::currentContext()->extraFunctions();
+
+	// Frames which are done already do not need to wait for the slot to come around
+	for(auto& frame : m_frames)
+	{
+		if(frame.fence && gl->glClientWaitSync(frame.fence, 0, 0) != GL_TIMEOUT_EXPIRED)
+			collect(frame);
+	}
+
+	// The slot of this frame is still in use by the GPU, this is the pacing
+	auto& frame = m_frames[m_current];
+	if(frame.fence)
+	{
+		gl->glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+		collect(frame);
+	}
+
+	frame.recorded.fill(false);
+}
+
+void FrameTimer::endFrame()
+{
+	if(!m_created)
+		return;
+
+	auto* gl = QOpenGLContext::currentContext()->extraFunctions();
+	m_frames[m_current].fence = gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	m_current = (m_current + 1) % MAX_FRAMES_IN_FLIGHT;
+}
+
+void FrameTimer::beginPass(PASS pass)
+{
+	if(m_created && m_timerQueries)
+		m_frames[m_current].queries[pass * 2]->recordTimestamp();
+}
+
+void FrameTimer::endPass(PASS pass)
+{
+	if(!m_created || !m_timerQueries)
+		return;
+
+	auto& frame = m_frames[m_current];
+	frame.queries[pass * 2 + 1]->recordTimestamp();
+	frame.recorded[pass] = true;
+}
+
+float FrameTimer::getGpuFrameTime() const
+{
+	float sum = 0.0f;
+	for(auto t : m_gpuTimes)
+		sum += t;
+
+	return sum;
+}
+
+void FrameTimer::collect(Frame& frame)
+{
+	auto* gl = QOpenGLContext::currentContext()->extraFunctions();
+	gl->glDeleteSync(frame.fence);
+	frame.fence = nullptr;
+
+	for(size_t pass = 0; pass < PASS_COUNT; pass++)
+	{
+		if(!frame.recorded[pass])
+			continue;
+
+		// The fence has passed, so the results are available without waiting
+		const auto begin = frame.queries[pass * 2]->waitForResult();
+		const auto end = frame.queries[pass * 2 + 1]->waitForResult();
+		m_gpuTimes[pass] = static_cast<float>(end - begin) / 1000000.0f;
+		frame.recorded[pass] = false;
+	}
+}
@@ -0,0 +1,73 @@
+#ifndef NEO_FRAMETIMER_H
+#define NEO_FRAMETIMER_H
+
+#include <QOpenGLTimerQuery>
+#include <qopengl.h>
+
+#include <array>
+#include <memory>
+
+namespace Neo 
+{
+
+/**
+ * Measures the GPU time of the passes of a frame and limits how many frames
+ * the GPU may lag behind the CPU.
+ *
+ * Every frame records timestamp queries around its passes and ends with a
+ * fence. Results are read back once the fence of the frame has passed, so the
+ * CPU never waits for the GPU unless MAX_FRAMES_IN_FLIGHT frames are queued.
+ * Timestamp queries need GL 3.3 or ARB_timer_query, without them only the
+ * pacing is done.
+ */
+class FrameTimer
+{
+public:
+	enum PASS
+	{
+		PASS_LEVEL,
+		PASS_ICONS,
+		PASS_IMGUI,
+		PASS_COUNT
+	};
+
+	static constexpr size_t MAX_FRAMES_IN_FLIGHT = 2;
+
+	/// Needs the context of the widget to be current
+	void create();
+	void destroy();
+
+	/// Waits until at most MAX_FRAMES_IN_FLIGHT - 1 frames are queued
+	void beginFrame();
+	void endFrame();
+
+	void beginPass(PASS pass);
+	void endPass(PASS pass);
+
+	bool hasGpuTimes() const { return m_timerQueries; }
+
+	/// The GPU time of the pass in ms in the latest finished frame
+	float getGpuTime(PASS pass) const { return m_gpuTimes[pass]; }
+	float getGpuFrameTime() const;
+
+private:
+	struct Frame
+	{
+		GLsync fence = nullptr;
+		std::array<std::unique_ptr<QOpenGLTimerQuery>, PASS_COUNT * 2> queries;
+		std::array<bool, PASS_COUNT> recorded = {};
+	};
+
+	void collect(Frame& frame);
+
+	std::array<Frame, MAX_FRAMES_IN_FLIGHT> m_frames;
+	size_t m_current = 0;
+	bool m_timerQueries = false;
+	bool m_created = false;
+
+	std::array<float, PASS_COUNT> m_gpuTimes = {};
+};
+
+}
+
+#endif // NEO_FRAMETIMER_H
@@ -4,13 +4,133 @@
 
 #include <QMessageBox>
 #include <QApplication>
+#include <QJsonObject>
+#include <QTextStream>
 
 using namespace Neo;
 
+namespace
+{
+
+constexpr float FIXED_TIME_STEP = 1.0f/60.0f;
+
+}
+
+QJsonObject GameWidget::PlayStatistics::toJson() const
+{
+	QJsonObject json;
+	json["update"] = update.toJson(true);
+	json["draw"] = draw.toJson(true);
+	return json;
+}
+
+QString GameWidget::PlayStatistics::toCsv() const
+{
+	QString csv;
+	QTextStream stream(&csv);
+	stream << "frame,update,draw\n";
+
+	for(size_t i = 0; i < update.size(); i++)
+		stream << i << "," << update.getFrameTimes()[i] << "," << draw.getFrameTimes()[i] << "\n";
+
+	return csv;
+}
+
 GameWidget::GameWidget(QWidget* parent):
 	OpenGLWidget(parent)
 {
 	m_camera.setParent(&m_cameraObject);
+	setMouseTracking(true);
+	setFocusPolicy(Qt::StrongFocus);
+}
+
+bool GameWidget::event(QEvent* e)
+{
+	// Without a game nothing would consume the events, keys like Tab keep their usual meaning
+	QtInputContext::Event event;
+	if(!m_game || !QtInputContext::translate(e, event))
+		return OpenGLWidget::event(e);
+
+	// Events are applied at the start of the next frame, so recordings know which frame they belong to
+	if(m_inputMode != INPUT_REPLAYING)
+		m_pendingInput.push_back(event);
+
+	e->accept();
+	return true;
+}
+
+void GameWidget::applyInput()
+{
+	auto& input = m_platform.getInputContext();
+	auto apply = [&input](const QtInputContext::Event& event) {
+		QtInputContext::apply(input, event);
+
+		if(!input.isMouseRelative()) // Only calculate direction from position when it is needed
+			input.getMouse().flushDirection();
+	};
+
+	if(m_inputMode == INPUT_REPLAYING)
+	{
+		m_recording.replay(m_frame, apply);
+		return;
+	}
+
+	for(auto& event : m_pendingInput)
+	{
+		if(m_inputMode == INPUT_RECORDING)
+			m_recording.record(m_frame, event);
+
+		apply(event);
+	}
+
+	m_pendingInput.clear();
+}
+
+void GameWidget::startRecordingInput()
+{
+	stopGame();
+	m_inputMode = INPUT_RECORDING;
+	m_recording.clear();
+}
+
+InputRecording GameWidget::stopRecordingInput()
+{
+	if(m_inputMode != INPUT_RECORDING)
+		return InputRecording();
+
+	if(m_game)
+		m_recording.setFrameCount(m_frame);
+
+	m_inputMode = INPUT_LIVE;
+	return std::move(m_recording);
+}
+
+void GameWidget::playTimedemo(const InputRecording& recording, std::function<void(const PlayStatistics&)> done)
+{
+	stopGame();
+
+	m_inputMode = INPUT_REPLAYING;
+	m_recording = recording;
+	m_timedemoDone = done;
+	m_frame = 0;
+
+	m_timedemo.update.clear();
+	m_timedemo.draw.clear();
+	m_timedemo.update.reserve(recording.getFrameCount());
+	m_timedemo.draw.reserve(recording.getFrameCount());
+}
+
+void GameWidget::finishTimedemo()
+{
+	// The game keeps running with live input until it is stopped
+	m_inputMode = INPUT_LIVE;
+	setFrameRateCapped(true);
+
+	auto done = std::move(m_timedemoDone);
+	m_timedemoDone = nullptr;
+
+	if(done)
+		done(m_timedemo);
 }
 
 void GameWidget::initializeGL()
@@ -66,8 +186,40 @@ void GameWidget::paintGL()
 		render->clear(57.0f/255.0f, 57.0f/255.0f, 57.0f/255.0f, true);
 		render->setBackbuffer((void*) defaultFramebufferObject());
 
-		m_game->update(m_platform, 1.0f/60.0f);
+		// Input stays queued while paused, so it is recorded for the frame which uses it
+		const bool advance = !m_paused || m_stepFrame;
+		m_stepFrame = false;
+
+		QElapsedTimer timer;
+		float updateTime = 0.0f;
+		if(advance)
+		{
+			applyInput();
+
+			// Live play keeps the fixed step as well, so it behaves the same as its recording and replays
+			const float dt = FIXED_TIME_STEP;
+
+			timer.start();
+			if(m_behaviorProfiler.isEnabled())
+				m_behaviorProfiler.update(*m_game, m_platform, dt);
+			else
+				m_game->update(m_platform, dt);
+			updateTime = timer.nsecsElapsed() / 1e6f;
+		}
+
+		timer.start();
 		m_game->draw(*render);
+		const float drawTime = timer.nsecsElapsed() / 1e6f;
+
+		if(advance)
+		{
+			m_frame++;
+			if(m_inputMode == INPUT_REPLAYING)
+			{
+				m_timedemo.update.add(updateTime);
+				m_timedemo.draw.add(drawTime);
+			}
+		}
 	}
 	else
 	{
@@ -76,6 +228,9 @@ void GameWidget::paintGL()
 
 	render->swapBuffers();
 	endFrame();
+
+	if(m_game && m_inputMode == INPUT_REPLAYING && m_frame >= m_recording.getFrameCount())
+		finishTimedemo();
 }
 
 void GameWidget::playGame(LevelGameState* state)
@@ -89,6 +244,21 @@ void GameWidget::playGame(LevelGameState* state)
 	
 	m_game = state;
 	m_needsInit = true;
+
+	m_frame = 0;
+	m_pendingInput.clear();
+	m_stepFrame = false;
+	m_behaviorProfiler.clear();
+
+	// Keys held when the last session ended must not leak into the first frame of this one
+	QtInputContext::reset(m_platform.getInputContext());
+
+	if(m_inputMode == INPUT_RECORDING)
+		m_recording.clear();
+	else if(m_inputMode == INPUT_REPLAYING)
+		setFrameRateCapped(false);
+
+	emit playingChanged(true);
 	repaint();
 }
 
@@ -98,12 +268,41 @@ void GameWidget::stopGame()
 	
 	if(m_game)
 	{
+		if(m_inputMode == INPUT_RECORDING)
+			m_recording.setFrameCount(m_frame);
+		else if(m_inputMode == INPUT_REPLAYING)
+		{
+			// Aborted before all frames were played
+			m_inputMode = INPUT_LIVE;
+			m_timedemoDone = nullptr;
+			setFrameRateCapped(true);
+		}
+
 		m_game->end();
 		m_game = nullptr;
+		emit playingChanged(false);
 	}
+
+	pauseGame(false);
 }
 
-void GameWidget::pauseGame()
+void GameWidget::pauseGame(bool paused)
 {
-	LOG_DEBUG("Pause game");
+	if(paused == m_paused || (paused && !m_game))
+		return;
+
+	LOG_DEBUG((paused ? "Pause game" : "Resume game"));
+	m_paused = paused;
+	m_stepFrame = false;
+
+	emit pausedChanged(paused);
+}
+
+void GameWidget::stepFrame()
+{
+	if(!m_game || !m_paused)
+		return;
+
+	m_stepFrame = true;
+	requestRedraw();
 }
@@ -2,12 +2,18 @@
 #define NEO_GAMEWIDGET_H
 
 #include "OpenGLWidget.h"
+#include "InputRecording.h"
 #include <Platform.h>
 #include <LevelGameState.h>
+#include <profiling/BehaviorProfiler.h>
+#include <profiling/FrameStatistics.h>
 
 #include <Object.h>
 #include <behaviors/CameraBehavior.h>
 
+#include <QElapsedTimer>
+#include <functional>
+
 namespace Neo 
 {
 
@@ -15,25 +21,87 @@ class GameWidget : public OpenGLWidget
 {
 	Q_OBJECT;
 public:
+	/// Update and draw times of every frame of a timedemo, the draw times are CPU only
+	struct PlayStatistics
+	{
+		FrameStatistics update, draw;
+
+		QJsonObject toJson() const;
+
+		/// One "frame,update,draw" line per frame, times in ms
+		QString toCsv() const;
+	};
+
 	GameWidget(QWidget* parent);
+
+	bool event(QEvent* e) override;
+
+	/// Records the input of the next game session, stops the running game
+	void startRecordingInput();
+	InputRecording stopRecordingInput();
+	bool isRecordingInput() const { return m_inputMode == INPUT_RECORDING; }
+
+	/**
+	 * Replays the recording in the next game session as fast as possible with
+	 * a fixed time step and ignores live input meanwhile. Stops the running game.
+	 * @param done Called with the statistics once all frames of the recording were played.
+	 */
+	void playTimedemo(const InputRecording& recording, std::function<void(const PlayStatistics&)> done);
+	bool isPlayingTimedemo() const { return m_inputMode == INPUT_REPLAYING; }
+
+	/// Takes over the behavior updates of the game while it is enabled, cleared when a game starts
+	BehaviorProfiler& getBehaviorProfiler() { return m_behaviorProfiler; }
 	
 public slots:
 	void playGame(LevelGameState*);
 	void stopGame();
-	void pauseGame();
+
+	/// A paused game is still drawn but only updated by stepFrame()
+	void pauseGame(bool paused);
+
+	/// Runs a single update with the fixed time step while paused
+	void stepFrame();
 	
 	bool isPlaying() const { return m_game != nullptr; }
+	bool isPaused() const { return m_paused; }
 	LevelGameState* getGame() { return m_game; }
 
+signals:
+	void playingChanged(bool playing);
+	void pausedChanged(bool paused);
+
 protected:
 	virtual void initializeGL();
 	virtual void resizeGL(int w, int h);
 	virtual void paintGL();
 	
 private:
+	enum INPUT_MODE
+	{
+		INPUT_LIVE,
+		INPUT_RECORDING,
+		INPUT_REPLAYING
+	};
+
+	/// Feeds the input of this frame into the platform
+	void applyInput();
+	void finishTimedemo();
+
 	Platform m_platform;
 	LevelGameState* m_game = nullptr;
 	bool m_needsInit = false;
+	bool m_paused = false;
+	bool m_stepFrame = false; // Requested while paused
+
+	INPUT_MODE m_inputMode = INPUT_LIVE;
+	std::vector<QtInputContext::Event> m_pendingInput; // Received since the last frame
+	InputRecording m_recording;
+	uint32_t m_frame = 0; // Frames since the game started
+
+	PlayStatistics m_timedemo;
+	std::function<void(const PlayStatistics&)> m_timedemoDone;
+
+	BehaviorProfiler m_behaviorProfiler;
 	
 	Object m_cameraObject;
 	CameraBehavior m_camera;
@@ -0,0 +1,223 @@
+#include "HeadlessRunner.h"
+#include "CameraPath.h"
+#include "LevelWidget.h"
+
+#include <profiling/TimedemoStatistics.h>
+#include <profiling/Trace.h>
+
+#include <Level.h>
+#include <LevelLoader.h>
+#include <Log.h>
+#include <Platform.h>
+#include <PlatformRenderer.h>
+#include <behaviors/CameraBehavior.h>
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QTextStream>
+
+#include <cmath>
+
+using namespace Neo;
+
+namespace
+{
+
+constexpr float ORBIT_ELEVATION = 30.0f; // Degrees above the horizon
+
+/// The center and radius of a sphere around all objects
+void fitOrbit(Level& level, Vector3& center, float& radius)
+{
+	std::vector<ObjectHandle> stack(level.getRoot()->getChildren().begin(), level.getRoot()->getChildren().end());
+	std::vector<Vector3> positions;
+
+	while(!stack.empty())
+	{
+		auto object = stack.back();
+		stack.pop_back();
+
+		positions.push_back(object->getGlobalPosition());
+		for(auto& child : object->getChildren())
+			stack.push_back(child);
+	}
+
+	center = Vector3();
+	radius = 10.0f;
+	if(positions.empty())
+		return;
+
+	for(auto& p : positions)
+		center = center + p;
+	center = center / static_cast<float>(positions.size());
+
+	float extent = 0.0f;
+	for(auto& p : positions)
+		extent = std::max(extent, (p - center).getLength());
+
+	radius = std::max(radius, extent * 1.5f);
+}
+
+/// Looks at the center from the given angle around the Z axis, the camera looks down -Z without rotation
+void placeCamera(Object& camera, const Vector3& center, float radius, float angle)
+{
+	const float elevation = ORBIT_ELEVATION * static_cast<float>(M_PI) / 180.0f;
+	const float rad = angle * static_cast<float>(M_PI) / 180.0f;
+	const float distance = radius * std::cos(elevation);
+
+	camera.setPosition(center + Vector3(distance * std::sin(rad), -distance * std::cos(rad), radius * std::sin(elevation)));
+	camera.setRotation(Quaternion(90.0f - ORBIT_ELEVATION, 0.0f, angle));
+	camera.updateMatrix();
+}
+
+bool writeJson(const QJsonObject& json, const QString& file)
+{
+	const auto data = QJsonDocument(json).toJson();
+	if(file.isEmpty())
+	{
+		QTextStream(stdout) << data;
+		return true;
+	}
+
+	QFile out(file);
+	if(!out.open(QFile::WriteOnly | QFile::Truncate) || out.write(data) != data.size())
+	{
+		LOG_ERROR("Could not write statistics to " << file.toStdString());
+		return false;
+	}
+
+	return true;
+}
+
+}
+
+int HeadlessRunner::run(const Options& options)
+{
+	QOffscreenSurface surface;
+	surface.setFormat(QSurfaceFormat::defaultFormat());
+	surface.create();
+
+	QOpenGLContext context;
+	context.setFormat(QSurfaceFormat::defaultFormat());
+	if(!context.create() || !context.makeCurrent(&surface))
+	{
+		LOG_ERROR("Could not create an offscreen OpenGL context!");
+		return 1;
+	}
+
+	auto* gl = context.functions();
+	const QString rendererName = reinterpret_cast<const char*>(gl->glGetString(GL_RENDERER));
+	LOG_INFO("Running headless on " << rendererName.toStdString());
+
+	QOpenGLFramebufferObjectFormat fboFormat;
+	fboFormat.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+
+	QOpenGLFramebufferObject fbo(options.size, fboFormat);
+	if(!fbo.isValid() || !fbo.bind())
+	{
+		LOG_ERROR("Could not create the offscreen framebuffer!");
+		return 1;
+	}
+
+	auto level = std::make_shared<Level>();
+	level->getPhysicsContext().setEnabled(false);
+
+	if(!LevelLoader::load(*level, options.level.toUtf8().data()))
+	{
+		LOG_ERROR("Could not load level: " << options.level.toStdString());
+		return 1;
+	}
+
+	const int width = options.size.width();
+	const int height = options.size.height();
+
+	// There is no window and the native context is only needed for sharing with it
+	Platform platform;
+	PlatformRenderer render;
+	render.initialize(width, height, (void*) static_cast<uintptr_t>(fbo.handle()), nullptr, nullptr, nullptr);
+	render.setViewport(0, 0, width, height);
+
+	Object cameraObject;
+	CameraBehavior camera;
+	camera.setParent(&cameraObject);
+
+	Vector3 center;
+	float radius;
+	fitOrbit(*level, center, radius);
+	if(options.orbitRadius > 0.0f)
+		radius = options.orbitRadius;
+
+	CameraPath path;
+	if(!options.cameraPath.isEmpty() && !path.load(options.cameraPath))
+		return 1;
+
+	const unsigned int frames = path.empty() ? options.frames : path.size();
+
+	try
+	{
+		level->begin(platform, render);
+		cameraObject.begin(platform, render, *level);
+		level->setCurrentCamera(&camera);
+	}
+	catch(const std::exception& e)
+	{
+		LOG_ERROR("Could not begin level: " << e.what());
+		return 1;
+	}
+
+	TimedemoStatistics statistics;
+	FrameStatistics cpuTimes;
+	statistics.reserve(frames);
+	cpuTimes.reserve(frames);
+
+	QElapsedTimer timer;
+	const unsigned int total = options.warmupFrames + frames;
+	for(unsigned int i = 0; i < total; i++)
+	{
+		TRACE_SCOPE("Headless frame");
+
+		// Warm-up frames stay at the start of the path
+		if(!path.empty())
+			path.apply(i < options.warmupFrames ? 0 : i - options.warmupFrames, cameraObject);
+		else
+			placeCamera(cameraObject, center, radius, 360.0f * i / frames);
+
+		timer.start();
+		camera.enable(width, height);
+		LevelWidget::stepLevel(*level, platform, render, 1.0f/60.0f);
+		const float cpu = timer.nsecsElapsed() / 1e6f;
+
+		// Without a swap chain nothing throttles the CPU, so wait for the GPU to measure whole frames
+		gl->glFinish();
+		const float frame = timer.nsecsElapsed() / 1e6f;
+
+		if(i >= options.warmupFrames)
+		{
+			cpuTimes.add(cpu);
+			statistics.addFrame(frame, render.getDrawCallCount(), render.getFaceCount());
+		}
+	}
+
+	level->end();
+
+	const auto summary = statistics.getFrameTimes().summarize();
+	LOG_INFO("Rendered " << summary.frames << " frames, p50 " << summary.p50 << "ms, p99 " << summary.p99 << "ms");
+
+	auto json = statistics.toJson();
+	json["level"] = options.level;
+	json["renderer"] = rendererName;
+	json["width"] = width;
+	json["height"] = height;
+	json["cpuTime"] = cpuTimes.toJson();
+
+	if(path.empty())
+		json["orbitRadius"] = radius;
+	else
+		json["cameraPath"] = options.cameraPath;
+
+	return writeJson(json, options.statistics) ? 0 : 1;
+}
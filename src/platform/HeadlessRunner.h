@@ -0,0 +1,39 @@
+#ifndef NEO_HEADLESSRUNNER_H
+#define NEO_HEADLESSRUNNER_H
+
+#include <QSize>
+#include <QString>
+
+namespace Neo
+{
+
+/**
+ * Renders a level without any window for automated performance runs.
+ *
+ * The level is drawn into a framebuffer object of a QOffscreenSurface through
+ * the same update and draw path as the LevelWidget, so it works with
+ * QT_QPA_PLATFORM=offscreen and software rasterizers like Mesa llvmpipe.
+ * The camera follows a recorded CameraPath or orbits the level. The frame
+ * times are written as JSON in the same format as an editor timedemo.
+ */
+class HeadlessRunner
+{
+public:
+	struct Options
+	{
+		QString level;
+		QString statistics; ///< JSON output, stdout if empty
+		QString cameraPath; ///< Plays every frame of the path instead of orbiting, overrides the frame count
+		QSize size = QSize(1280, 720);
+		unsigned int frames = 600;
+		unsigned int warmupFrames = 30; ///< Rendered before measuring, e.g. to upload resources
+		float orbitRadius = 0.0f; ///< 0 fits the orbit to the level
+	};
+
+	/// Returns the exit code for the application
+	static int run(const Options& options);
+};
+
+}
+
+#endif // NEO_HEADLESSRUNNER_H
@@ -0,0 +1,71 @@
+#include "InputRecording.h"
+
+#include <Log.h>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+using namespace Neo;
+
+bool InputRecording::save(const QString& file) const
+{
+	QJsonArray events;
+	for(auto& e : m_entries)
+		events.append(QJsonArray({static_cast<qint64>(e.frame), e.event.type, e.event.code, e.event.value.x, e.event.value.y}));
+
+	QJsonObject json;
+	json["frames"] = static_cast<qint64>(m_frameCount);
+	json["events"] = events;
+
+	QFile out(file);
+	const auto data = QJsonDocument(json).toJson(QJsonDocument::Compact);
+	if(!out.open(QFile::WriteOnly | QFile::Truncate) || out.write(data) != data.size())
+	{
+		LOG_ERROR("Could not write input recording: " << file.toStdString());
+		return false;
+	}
+
+	return true;
+}
+
+bool InputRecording::load(const QString& file)
+{
+	QFile in(file);
+	if(!in.open(QFile::ReadOnly))
+	{
+		LOG_ERROR("Could not open input recording: " << file.toStdString());
+		return false;
+	}
+
+	const auto json = QJsonDocument::fromJson(in.readAll()).object();
+	const auto events = json["events"].toArray();
+
+	std::vector<Entry> entries;
+	entries.reserve(events.size());
+	for(const auto& value : events)
+	{
+		const auto e = value.toArray();
+		const int frame = e[0].toInt(-1);
+		const int type = e[1].toInt(-1);
+		if(e.size() != 5 || frame < 0 || type < QtInputContext::Event::EVENT_KEY_DOWN || type > QtInputContext::Event::EVENT_WHEEL
+			|| (!entries.empty() && entries.back().frame > static_cast<uint32_t>(frame)))
+		{
+			LOG_ERROR("Invalid input recording: " << file.toStdString());
+			return false;
+		}
+
+		Entry entry;
+		entry.frame = frame;
+		entry.event.type = static_cast<QtInputContext::Event::TYPE>(type);
+		entry.event.code = e[2].toInt();
+		entry.event.value = Vector2(e[3].toDouble(), e[4].toDouble());
+		entries.push_back(entry);
+	}
+
+	m_entries = std::move(entries);
+	m_frameCount = json["frames"].toInt();
+	m_cursor = 0;
+	return m_frameCount > 0;
+}
@@ -0,0 +1,68 @@
+#ifndef NEO_INPUTRECORDING_H
+#define NEO_INPUTRECORDING_H
+
+#include "QtInputContext.h"
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+namespace Neo
+{
+
+/**
+ * The input events of a game session, grouped by the frame they were applied in.
+ *
+ * Replaying a recording feeds the same events into the same frames, so a game
+ * running with a fixed time step reproduces the session exactly.
+ * Stored as JSON with one [frame, type, code, x, y] entry per event.
+ */
+class InputRecording
+{
+public:
+	struct Entry
+	{
+		uint32_t frame = 0;
+		QtInputContext::Event event;
+	};
+
+	void clear()
+	{
+		m_entries.clear();
+		m_frameCount = 0;
+		m_cursor = 0;
+	}
+
+	/// Events need to be recorded in frame order
+	void record(uint32_t frame, const QtInputContext::Event& event) { m_entries.push_back({frame, event}); }
+
+	/// The length of the session including the frames after the last event
+	uint32_t getFrameCount() const { return m_frameCount; }
+	void setFrameCount(uint32_t frames) { m_frameCount = frames; }
+
+	/// Calls fn(const QtInputContext::Event&) for all events of the frame, frames need to be replayed in order
+	template<typename Fn>
+	void replay(uint32_t frame, Fn fn)
+	{
+		if(frame == 0)
+			m_cursor = 0;
+
+		for(; m_cursor < m_entries.size() && m_entries[m_cursor].frame <= frame; m_cursor++)
+		{
+			if(m_entries[m_cursor].frame == frame)
+				fn(m_entries[m_cursor].event);
+		}
+	}
+
+	bool save(const QString& file) const;
+	bool load(const QString& file);
+
+private:
+	std::vector<Entry> m_entries;
+	uint32_t m_frameCount = 0;
+	size_t m_cursor = 0; // Next entry to replay
+};
+
+}
+
+#endif // NEO_INPUTRECORDING_H
@@ -4,19 +4,23 @@
 #include <Log.h>
 
 #include "QtInputContext.h"
+#include <profiling/Profiler.h>
 
 #include <QEvent>
-#include <QKeyEvent>
-#include <QMouseEvent>
 #include <QMessageBox>
-#include <QWheelEvent>
+
+#include <algorithm>
+#include <unordered_set>
 
 using namespace Neo;
 
 LevelWidget::LevelWidget(QWidget* parent):
 	OpenGLWidget(parent),
-	m_level(std::make_shared<Level>())
+	m_level(std::make_shared<Level>()),
+	m_names(m_journal)
 {
+	m_names.setLevel(m_level);
+	m_allocator.setLevel(m_level.get());
 	m_camera.setParent(&m_cameraObject);
 	setMouseTracking(true);
 	setFocusPolicy(Qt::StrongFocus);
@@ -38,12 +42,19 @@ void LevelWidget::resizeGL(int w, int h)
 void LevelWidget::paintGL()
 {
 	auto& input = m_platform.getInputContext();
+	const auto cameraPosition = m_cameraObject.getPosition();
+	const auto cameraRotation = m_cameraObject.getRotation().getEulerAngles();
 
-	if(hasFocus())
+	// While a camera path plays, the camera only follows the path
+	const bool followingPath = updateCameraPath();
+	if(!followingPath && hasFocus())
 	{
+		PROFILE_SCOPE("Camera Input");
+
 		// If an input script is registered, use that
 		if(m_inputMethod)
 		{
+			PROFILE_SCOPE("UpdateInput");
 			if(m_inputMethod->startCallFunction("UpdateInput"))
 			{
 				pushPlatform(m_inputMethod->getState(), &m_platform);
@@ -72,9 +83,16 @@ void LevelWidget::paintGL()
 		}
 	}
 	input.getMouse().setDirection(Vector2());
+
+	// Keep drawing while the camera moves, e.g. while a movement key is held down
+	if(cameraPosition != m_cameraObject.getPosition() || cameraRotation != m_cameraObject.getRotation().getEulerAngles())
+		requestRedraw();
 	
 	m_cameraObject.updateMatrix();
 	m_camera.enable(width(), height());
+
+	if(m_cameraPathMode == CAMERA_PATH_RECORDING)
+		m_cameraPath.record(m_cameraObject);
 	
 	if(m_levelNeedsInit)
 	{
@@ -94,300 +112,167 @@ void LevelWidget::paintGL()
 
 		m_level->setCurrentCamera(&m_camera);
 		m_levelNeedsInit = false;
+
+		// Everything has been started already
+		m_pendingObjects.clear();
+		m_pendingBehaviors.clear();
+	}
+	else
+	{
+		beginPending();
 	}
 
-	m_level->update(m_platform, 1.0f/60.0f);
+	// render->setCurrentFBO(defaultFramebufferObject());
+	stepLevel(*m_level, m_platform, *getRenderer(), 1.0f/60.0f);
 
-	auto render = getRenderer();
+	if(m_cameraPathMode == CAMERA_PATH_PLAYING)
+	{
+		m_drawCalls = getRenderer()->getDrawCallCount();
+		m_triangles = getRenderer()->getFaceCount();
+	}
+}
 
-	// render->setCurrentFBO(defaultFramebufferObject());
-	m_level->draw(*render, true);
-	render->swapBuffers();
+void LevelWidget::stepLevel(Level& level, Platform& platform, PlatformRenderer& render, float dt)
+{
+	{
+		PROFILE_SCOPE("Level::update");
+		level.update(platform, dt);
+	}
+
+	{
+		PROFILE_SCOPE("Level::draw");
+		level.draw(render, true);
+		render.swapBuffers();
+	}
 }
 
-namespace
+void LevelWidget::startRecordingCameraPath()
 {
+	m_cameraPath.clear();
+	m_cameraPathMode = CAMERA_PATH_RECORDING;
+	setAnimating(&m_cameraPath, true);
+}
 
-INPUT_KEYS translateEvent(int key)
+CameraPath LevelWidget::stopRecordingCameraPath()
 {
-	switch (key)
+	if(m_cameraPathMode != CAMERA_PATH_RECORDING)
+		return CameraPath();
+
+	m_cameraPathMode = CAMERA_PATH_NONE;
+	setAnimating(&m_cameraPath, false);
+	return std::move(m_cameraPath);
+}
+
+void LevelWidget::playCameraPath(const CameraPath& path, std::function<void(const TimedemoStatistics&)> done)
+{
+	if(path.empty())
+		return;
+
+	m_cameraPath = path;
+	m_cameraPathFrame = 0;
+	m_cameraPathMode = CAMERA_PATH_PLAYING;
+
+	m_timedemo.clear();
+	m_timedemo.reserve(path.size());
+	m_timedemoDone = done;
+
+	setFrameRateCapped(false);
+	setAnimating(&m_cameraPath, true);
+}
+
+bool LevelWidget::updateCameraPath()
+{
+	if(m_cameraPathMode != CAMERA_PATH_PLAYING)
+		return false;
+
+	// A frame lasts until the next one begins, so this includes everything drawn after the level
+	if(m_cameraPathFrame > 0)
+		m_timedemo.addFrame(m_timedemoTimer.nsecsElapsed() / 1e6f, m_drawCalls, m_triangles);
+
+	if(m_cameraPathFrame == m_cameraPath.size())
 	{
-		case Qt::Key_A:
-			return KEY_A;
-		case Qt::Key_B:
-			return KEY_B;
-		case Qt::Key_C:
-			return KEY_C;
-		case Qt::Key_D:
-			return KEY_D;
-		case Qt::Key_E:
-			return KEY_E;
-		case Qt::Key_F:
-			return KEY_F;
-		case Qt::Key_G:
-			return KEY_G;
-		case Qt::Key_H:
-			return KEY_H;
-		case Qt::Key_I:
-			return KEY_I;
-		case Qt::Key_J:
-			return KEY_J;
-		case Qt::Key_K:
-			return KEY_K;
-		case Qt::Key_L:
-			return KEY_L;
-		case Qt::Key_M:
-			return KEY_M;
-		case Qt::Key_N:
-			return KEY_N;
-		case Qt::Key_O:
-			return KEY_O;
-		case Qt::Key_P:
-			return KEY_P;
-		case Qt::Key_Q:
-			return KEY_Q;
-		case Qt::Key_R:
-			return KEY_R;
-		case Qt::Key_S:
-			return KEY_S;
-		case Qt::Key_T:
-			return KEY_T;
-		case Qt::Key_U:
-			return KEY_U;
-		case Qt::Key_V:
-			return KEY_V;
-		case Qt::Key_W:
-			return KEY_W;
-		case Qt::Key_X:
-			return KEY_X;
-		case Qt::Key_Y:
-			return KEY_Y;
-		case Qt::Key_Z:
-			return KEY_Z;
-
-#if 0
-		case Qt::Key_0:
-			return KEY_KP0;
-		case Qt::Key_ _KP_1:
-			return KEY_KP1;
-		case Qt::Key_KP_2:
-			return KEY_KP2;
-		case Qt::Key_KP_3:
-			return KEY_KP3;
-		case Qt::Key_KP_4:
-			return KEY_KP4;
-		case Qt::Key_KP_5:
-			return KEY_KP5;
-		case Qt::Key_KP_6:
-			return KEY_KP6;
-		case Qt::Key_KP_7:
-			return KEY_KP7;
-		case Qt::Key_KP_8:
-			return KEY_KP8;
-		case Qt::Key_KP_9:
-			return KEY_KP9;
-#endif
-			
-		case Qt::Key_0:
-			return KEY_0;
-		case Qt::Key_1:
-			return KEY_1;
-		case Qt::Key_2:
-			return KEY_2;
-		case Qt::Key_3:
-			return KEY_3;
-		case Qt::Key_4:
-			return KEY_4;
-		case Qt::Key_5:
-			return KEY_5;
-		case Qt::Key_6:
-			return KEY_6;
-		case Qt::Key_7:
-			return KEY_7;
-		case Qt::Key_8:
-			return KEY_8;
-		case Qt::Key_9:
-			return KEY_9;
-
-#if 0
-		case Qt::Key_KP_ENTER:
-			return KEY_KP_ENTER;
-#endif
-		case Qt::Key_Space:
-			return KEY_SPACE;
-		case Qt::Key_Escape:
-			return KEY_ESCAPE;
-		case Qt::Key_Tab:
-			return KEY_TAB;
-			
-		case Qt::Key_Shift:
-			return KEY_LSHIFT;
-#if 0
-		case Qt::Key_RSHIFT:
-			return KEY_RSHIFT;
-#endif
-			
-		case Qt::Key_Control:
-			return KEY_LCONTROL;
-		
-#if 0
-		case Qt::Key_RCTRL:
-			return KEY_RCONTROL;
-#endif
-			
-		case Qt::Key_Alt:
-			return KEY_LALT;
-
-		case Qt::Key_Mode_switch:
-		case Qt::Key_AltGr:
-			return KEY_RALT;
-		case Qt::Key_Super_L:
-			return KEY_LSUPER;
-		case Qt::Key_Super_R:
-			return KEY_RSUPER;
-		case Qt::Key_Menu:
-			return KEY_MENU;
-		case Qt::Key_NumLock:
-			return KEY_NUMLOCK;
-		case Qt::Key_Pause:
-			return KEY_PAUSE;
-		case Qt::Key_Delete:
-			return KEY_DELETE;
-		case Qt::Key_Backspace:
-			return KEY_BACKSPACE;
-		case Qt::Key_Return:
-			return KEY_RETURN;
-		case Qt::Key_Home:
-			return KEY_HOME;
-		case Qt::Key_End:
-			return KEY_END;
-		case Qt::Key_PageUp:
-			return KEY_PAGEUP;
-		case Qt::Key_PageDown:
-			return KEY_PAGEDOWN;
-		case Qt::Key_Insert:
-			return KEY_INSERT;
-
-		case Qt::Key_Left:
-			return KEY_LEFT_ARROW;
-		case Qt::Key_Right:
-			return KEY_RIGHT_ARROW;
-		case Qt::Key_Down:
-			return KEY_DOWN_ARROW;
-		case Qt::Key_Up:
-			return KEY_UP_ARROW;
-
-		case Qt::Key_F1:
-			return KEY_F1;
-		case Qt::Key_F2:
-			return KEY_F2;
-		case Qt::Key_F3:
-			return KEY_F3;
-		case Qt::Key_F4:
-			return KEY_F4;
-		case Qt::Key_F5:
-			return KEY_F5;
-		case Qt::Key_F6:
-			return KEY_F6;
-		case Qt::Key_F7:
-			return KEY_F7;
-		case Qt::Key_F8:
-			return KEY_F8;
-		case Qt::Key_F9:
-			return KEY_F9;
-		case Qt::Key_F10:
-			return KEY_F10;
-		case Qt::Key_F11:
-			return KEY_F11;
-		case Qt::Key_F12:
-			return KEY_F12;
-
-		default:
-			break;
+		m_cameraPathMode = CAMERA_PATH_NONE;
+		setFrameRateCapped(true);
+		setAnimating(&m_cameraPath, false);
+
+		if(m_timedemoDone)
+			m_timedemoDone(m_timedemo);
+
+		m_timedemoDone = nullptr;
+		return false;
 	}
 
-	return KEY_DUMMY;
+	m_timedemoTimer.start();
+	m_cameraPath.apply(m_cameraPathFrame++, m_cameraObject);
+	return true;
+}
+
+static bool hasBehavior(ObjectHandle object, const Behavior* behavior)
+{
+	if(object.empty() || ObjectAllocator::isDead(object))
+		return false;
+
+	for(auto& b : object->getBehaviors())
+		if(b.get() == behavior)
+			return true;
+
+	return false;
 }
+
+void LevelWidget::forgetRemovedBehaviors()
+{
+	auto removed = [](const std::pair<ObjectHandle, Behavior*>& p) { return !hasBehavior(p.first, p.second); };
+	m_pendingBehaviors.erase(std::remove_if(m_pendingBehaviors.begin(), m_pendingBehaviors.end(), removed), m_pendingBehaviors.end());
 }
 
-bool LevelWidget::event(QEvent* e)
+void LevelWidget::beginPending()
 {
-	auto& input = m_platform.getInputContext();
+	if(m_pendingObjects.empty() && m_pendingBehaviors.empty())
+		return;
 
-	switch(e->type())
+	// The queue can be old with on demand redraws, objects might have been deleted meanwhile
+	std::unordered_set<ObjectHandle, ObjectHandleHash> begun;
+	std::unordered_set<Behavior*> begunBehaviors;
+
+	try
 	{
-		case QEvent::KeyPress:
-		{
-			QKeyEvent* key = static_cast<QKeyEvent*>(e);
-			input.getKeyboard().keyDown(translateEvent(key->key()));
-		}
-		break;
-		
-		case QEvent::KeyRelease:
-		{
-			QKeyEvent* key = static_cast<QKeyEvent*>(e);
-			input.getKeyboard().keyUp(translateEvent(key->key()));
-		}
-		break;
-		
-		case QEvent::MouseMove:
+		for(auto& object : m_pendingObjects)
 		{
-			QMouseEvent* mouse = static_cast<QMouseEvent*>(e);
-			input.getMouse().moveCursor(Vector2(mouse->x(), mouse->y()));
+			if(!object.empty() && !ObjectAllocator::isDead(object) && begun.insert(object).second)
+				object->begin(m_platform, *getRenderer(), *m_level);
 		}
-		break;
-			
-		case QEvent::MouseButtonPress:
-		{
-			QMouseEvent* mouse = static_cast<QMouseEvent*>(e);
-			switch(mouse->button())
-			{
-				case Qt::LeftButton:
-					input.getMouse().keyDown(MOUSE_BUTTON_LEFT);
-				break;
-				case Qt::RightButton:
-					input.getMouse().keyDown(MOUSE_BUTTON_RIGHT);
-				break;
-				case Qt::MiddleButton:
-					input.getMouse().keyDown(MOUSE_BUTTON_MIDDLE);
-				break;
-			}
-		}
-		break;
-			
-		case QEvent::MouseButtonRelease:
-		{
-			QMouseEvent* mouse = static_cast<QMouseEvent*>(e);
-			switch(mouse->button())
-			{
-				case Qt::LeftButton:
-					input.getMouse().keyUp(MOUSE_BUTTON_LEFT);
-				break;
-				case Qt::RightButton:
-					input.getMouse().keyUp(MOUSE_BUTTON_RIGHT);
-				break;
-				case Qt::MiddleButton:
-					input.getMouse().keyUp(MOUSE_BUTTON_MIDDLE);
-				break;
-			}
-		}
-		break;
-		
-		case QEvent::Wheel:
+
+		// Only the behaviors of the owning object are checked, behaviors queued twice are skipped
+		for(auto& p : m_pendingBehaviors)
 		{
-			QWheelEvent* mouse = static_cast<QWheelEvent*>(e);
-			float scroll = mouse->angleDelta().y();
-			input.getMouse().setScrollValue(scroll);
+			if(hasBehavior(p.first, p.second) && begunBehaviors.insert(p.second).second)
+				begin(p.second);
 		}
-		break;
-
-		default:
-			return OpenGLWidget::event(e);
 	}
+	catch(const std::exception& e)
+	{
+		LOG_ERROR("Could not begin object: " << e.what());
+		QMessageBox::critical(this, tr("Could not begin Object"), e.what());
+	}
+
+	m_pendingObjects.clear();
+	m_pendingBehaviors.clear();
+}
+
+bool LevelWidget::event(QEvent* e)
+{
+	auto& input = m_platform.getInputContext();
+
+	QtInputContext::Event event;
+	if(!QtInputContext::translate(e, event))
+		return OpenGLWidget::event(e);
+
+	QtInputContext::apply(input, event);
 	
 	if(!input.isMouseRelative()) // Only calculate direction from position when it is needed
 		input.getMouse().flushDirection();
 	
+	requestRedraw();
 	e->accept();
 	return true;
 }
@@ -3,13 +3,21 @@
 
 #include "QtInputContext.h"
 #include "OpenGLWidget.h"
+#include "CameraPath.h"
 #include <Platform.h>
+#include <LevelJournal.h>
+#include <NameIndex.h>
+#include <ObjectAllocator.h>
+#include <profiling/TimedemoStatistics.h>
 
 #include <Object.h>
 #include <behaviors/CameraBehavior.h>
 #include <Log.h>
 #include <LuaScript.h>
 
+#include <QElapsedTimer>
+#include <functional>
+
 namespace Neo 
 {
 
@@ -22,14 +30,50 @@ public:
 	{
 		m_level = level;
 		m_levelNeedsInit = true;
+		m_journal.reset();
+		m_names.setLevel(level);
+		m_allocator.setLevel(level.get());
+		requestRedraw();
 	}
 
+	/// Re-initializes the whole level on the next frame
 	void setNeedsInit(bool v)
 	{
 		m_levelNeedsInit = v;
+		requestRedraw();
+	}
+
+	/// Begins only the given object on the next frame, use when adding objects to a running level
+	void beginObject(ObjectHandle object) { m_pendingObjects.push_back(object); requestRedraw(); }
+
+	/// Begins only the given behavior of the object on the next frame, use when adding behaviors to an
+	/// existing object. Skipped if the behavior is not part of the object anymore by then.
+	void beginBehavior(ObjectHandle object, Behavior* behavior)
+	{
+		m_pendingBehaviors.emplace_back(object, behavior);
+		requestRedraw();
 	}
 
+	/// Begins a behavior of the editor camera right away, the camera is not part of the level
+	void beginCameraBehavior(Behavior* behavior)
+	{
+		makeCurrent();
+		begin(behavior);
+		doneCurrent();
+		requestRedraw();
+	}
+
+	/**
+	 * Drops queued behaviors which were removed from their object since.
+	 * Call before the removed behaviors are destroyed, a new behavior could
+	 * otherwise reuse the address and get begun twice.
+	 */
+	void forgetRemovedBehaviors();
+
 	std::shared_ptr<Level> getLevel() { return m_level; }
+	LevelJournal& getJournal() { return m_journal; }
+	NameIndex& getNameIndex() { return m_names; }
+	ObjectAllocator& getAllocator() { return m_allocator; }
 	CameraBehavior& getCamera() { return m_camera; }
 	Platform& getPlatform() { return m_platform; }
 	void begin(Behavior* b) { b->begin(m_platform, *getRenderer(), *m_level); }
@@ -41,6 +85,23 @@ public:
 
 	std::shared_ptr<Neo::LuaScript> getInputMethod() { return m_inputMethod; }
 	void setInputMethod(std::shared_ptr<Neo::LuaScript> s) { m_inputMethod = s; }
+
+	/// Updates and draws one frame of a running level, shared with the HeadlessRunner
+	static void stepLevel(Level& level, Platform& platform, PlatformRenderer& render, float dt);
+
+	/// Records the camera transformation of every frame, redraws continuously meanwhile
+	void startRecordingCameraPath();
+	CameraPath stopRecordingCameraPath();
+
+	/**
+	 * Replays the path one recorded frame per drawn frame without a frame rate cap
+	 * and ignores camera input meanwhile.
+	 * @param done Called with the statistics of the run once the last frame was drawn.
+	 */
+	void playCameraPath(const CameraPath& path, std::function<void(const TimedemoStatistics&)> done);
+
+	bool isRecordingCameraPath() const { return m_cameraPathMode == CAMERA_PATH_RECORDING; }
+	bool isPlayingCameraPath() const { return m_cameraPathMode == CAMERA_PATH_PLAYING; }
 	
 protected:
 	virtual void initializeGL();
@@ -48,7 +109,22 @@ protected:
 	virtual void paintGL();
 
 private:
+	enum CAMERA_PATH_MODE
+	{
+		CAMERA_PATH_NONE,
+		CAMERA_PATH_RECORDING,
+		CAMERA_PATH_PLAYING
+	};
+
+	void beginPending();
+
+	/// Moves the camera along the played path, returns false if no path is played
+	bool updateCameraPath();
+
 	std::shared_ptr<Level> m_level;
+	LevelJournal m_journal;
+	NameIndex m_names;
+	ObjectAllocator m_allocator;
 	
 	Platform m_platform;
 
@@ -57,9 +133,20 @@ private:
 	float m_movementSpeed = 1.0f; // Movement speed of the camera
 
 	bool m_levelNeedsInit = false;
+	std::vector<ObjectHandle> m_pendingObjects;
+	std::vector<std::pair<ObjectHandle, Behavior*>> m_pendingBehaviors;
 
 	// The current input script
 	std::shared_ptr<Neo::LuaScript> m_inputMethod = nullptr;
+
+	CAMERA_PATH_MODE m_cameraPathMode = CAMERA_PATH_NONE;
+	CameraPath m_cameraPath;
+	size_t m_cameraPathFrame = 0; // Next frame to play
+
+	TimedemoStatistics m_timedemo;
+	std::function<void(const TimedemoStatistics&)> m_timedemoDone;
+	QElapsedTimer m_timedemoTimer; // Started when a played frame begins
+	unsigned int m_drawCalls = 0, m_triangles = 0; // Of the last played frame
 };
 
 }
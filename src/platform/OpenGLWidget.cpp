@@ -78,8 +78,41 @@ float OpenGLWidget::endFrame()
 	const auto dt = t - m_frameBeginTime;
 	m_dt = static_cast<float>(dt) / 1000.0f;
 
-	const auto sleepTime = std::max(1, static_cast<int>(std::floor((1000.0f / m_fps) - m_dt)));
-	m_redrawTimer.start(sleepTime);
+	if(isRedrawingContinuously())
+	{
+		const auto sleepTime = std::max(1, static_cast<int>(std::floor((1000.0f / m_fps) - m_dt)));
+		m_redrawTimer.start(m_frameRateCapped ? sleepTime : 0);
+	}
 	
 	return m_dt;
 }
+
+void OpenGLWidget::setRedrawPolicy(REDRAW_POLICY policy)
+{
+	m_redrawPolicy = policy;
+	requestRedraw();
+}
+
+void OpenGLWidget::requestRedraw()
+{
+	if(m_redrawTimer.isActive())
+		return;
+
+	using namespace std;
+	using namespace chrono;
+	const auto t = duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+	const auto sinceLastFrame = static_cast<float>(t - m_frameBeginTime) / 1000.0f;
+
+	// Input can arrive a lot faster than the frame rate
+	m_redrawTimer.start(std::max(0, static_cast<int>(std::floor((1000.0f / m_fps) - sinceLastFrame))));
+}
+
+void OpenGLWidget::setAnimating(const void* owner, bool animating)
+{
+	if(animating)
+		m_animations.insert(owner);
+	else
+		m_animations.erase(owner);
+
+	requestRedraw();
+}
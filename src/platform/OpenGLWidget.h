@@ -5,6 +5,7 @@
 #include <QOpenGLWidget>
 #include <memory>
 #include <functional>
+#include <unordered_set>
 
 #include <Vector4.h>
 #include <PlatformRenderer.h>
@@ -17,17 +18,45 @@ class Window;
 class Platform;
 class Renderer;
 
+enum REDRAW_POLICY
+{
+	REDRAW_CONTINUOUS, ///< Redraw at the target frame rate all the time
+	REDRAW_ON_DEMAND ///< Only redraw after requestRedraw() or while something is animating
+};
+
 class OpenGLWidget : public QOpenGLWidget
 {
 	std::unique_ptr<PlatformRenderer> m_render;
 	QTimer m_redrawTimer;
 
+	REDRAW_POLICY m_redrawPolicy = REDRAW_CONTINUOUS;
+	bool m_frameRateCapped = true;
+	std::unordered_set<const void*> m_animations;
+
 public:
 	OpenGLWidget(QWidget* parent);
 
 	void beginFrame();
 	float endFrame();
 
+	void setRedrawPolicy(REDRAW_POLICY policy);
+	REDRAW_POLICY getRedrawPolicy() const { return m_redrawPolicy; }
+
+	/// Schedules a frame, requests are merged and limited to the target frame rate
+	void requestRedraw();
+
+	/**
+	 * Keeps redrawing continuously while any owner is animating, regardless
+	 * of the redraw policy.
+	 * @param owner Identifies who animates so independent animations do not interfere.
+	 */
+	void setAnimating(const void* owner, bool animating);
+	bool isRedrawingContinuously() const { return m_redrawPolicy == REDRAW_CONTINUOUS || !m_animations.empty(); }
+
+	/// Without the cap, continuous redraws start the next frame right away instead of waiting for the target frame rate
+	void setFrameRateCapped(bool capped) { m_frameRateCapped = capped; }
+	bool isFrameRateCapped() const { return m_frameRateCapped; }
+
 	float getDeltaTime() const { return m_dt; }
 	PlatformRenderer* getRenderer() { return m_render.get(); }
 
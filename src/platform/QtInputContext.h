@@ -4,12 +4,41 @@
 #include <InputContext.h>
 #include <unordered_map>
 
+class QEvent;
+
 class QtInputContext : public Neo::InputContext
 {
 public:
+	/// An input event in engine terms, so it can be recorded and replayed
+	struct Event
+	{
+		enum TYPE
+		{
+			EVENT_KEY_DOWN,
+			EVENT_KEY_UP,
+			EVENT_MOUSE_MOVE,
+			EVENT_MOUSE_DOWN,
+			EVENT_MOUSE_UP,
+			EVENT_WHEEL
+		};
+
+		TYPE type = EVENT_KEY_DOWN;
+		int code = 0; ///< The key or mouse button
+		Neo::Vector2 value; ///< The cursor position or the scroll value in y
+	};
+
 	QtInputContext(): InputContext() {}
 	virtual void handleInput();
 	virtual void setMouseRelative(bool value);
+
+	static Neo::INPUT_KEYS translateKey(int key);
+
+	/// Returns false if the event is no keyboard or mouse input
+	static bool translate(QEvent* e, Event& event);
+	static void apply(Neo::InputContext& input, const Event& event);
+
+	/// Releases all keys and mouse buttons and puts the cursor at the origin without movement
+	static void reset(Neo::InputContext& input);
 };
 
 #endif //NEO_SDLINPUTCONTEXT_H
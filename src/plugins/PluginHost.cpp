@@ -15,6 +15,7 @@
 namespace fs = std::filesystem;
 
 #include <Log.h>
+#include <profiling/Trace.h>
 
 using namespace Neo;
 
@@ -92,6 +93,14 @@ static int GetEditorSelection(lua_State* L)
 	return 1;
 }
 
+// SetEditorAnimating(bool): Keeps the viewport redrawing while the plugin animates something
+static int SetEditorAnimating(lua_State* L)
+{
+	auto* win = PluginHost::get().getWindow();
+	win->getEditor()->setAnimating(L, lua_toboolean(L, 1));
+	return 0;
+}
+
 static int GetEditorMovementSpeed(lua_State* L)
 {
 	auto* win = PluginHost::get().getWindow();
@@ -105,6 +114,7 @@ static int GetEditorMovementSpeed(lua_State* L)
 
 void PluginHost::load(const std::string& file)
 {
+	TRACE_SCOPE("PluginHost::load", file);
 	auto P = std::make_shared<LuaScript>();
 	auto* L = P->getState();
 
@@ -114,6 +124,7 @@ void PluginHost::load(const std::string& file)
 	lua_register(L, "GetEditorCamera", LuaBindings::GetEditorCamera);
 	lua_register(L, "GetEditorSelection", LuaBindings::GetEditorSelection);
 	lua_register(L, "GetEditorMovementSpeed", LuaBindings::GetEditorMovementSpeed);
+	lua_register(L, "SetEditorAnimating", LuaBindings::SetEditorAnimating);
 
 	lua_register(L, "AddMenuAction", [](lua_State* L) -> int
 	{
@@ -0,0 +1,62 @@
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+// Trivially initialized, so it is safe to use before any constructor of the thread ran
+thread_local uint64_t s_allocations = 0;
+
+void* allocate(std::size_t size)
+{
+	s_allocations++;
+
+	if(size == 0)
+		size = 1;
+
+	while(true)
+	{
+		if(void* p = std::malloc(size))
+			return p;
+
+		auto handler = std::get_new_handler();
+		if(!handler)
+			throw std::bad_alloc();
+
+		handler();
+	}
+}
+
+void* allocateNoThrow(std::size_t size) noexcept
+{
+	try
+	{
+		return allocate(size);
+	}
+	catch(...)
+	{
+		return nullptr;
+	}
+}
+
+}
+
+uint64_t AllocationCounter::get()
+{
+	return s_allocations;
+}
+
+// The aligned overloads are left to the standard library, they pair with their own delete
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
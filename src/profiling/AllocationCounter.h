@@ -0,0 +1,23 @@
+#ifndef NEOEDITOR_ALLOCATIONCOUNTER_H
+#define NEOEDITOR_ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+/**
+ * Counts the heap allocations of the calling thread.
+ *
+ * The editor replaces the global operator new, which increments a thread
+ * local counter before calling malloc. Comparing the count before and after
+ * a call tells how many allocations it made, including those of code in
+ * other libraries as long as they share the allocator of the executable.
+ * On Windows every DLL brings its own operator new, so allocations made
+ * inside the engine or game plugins are not counted there.
+ */
+class AllocationCounter
+{
+public:
+	/// Allocations of the calling thread since it started
+	static uint64_t get();
+};
+
+#endif // NEOEDITOR_ALLOCATIONCOUNTER_H
@@ -0,0 +1,128 @@
+#include "BehaviorProfiler.h"
+#include "AllocationCounter.h"
+
+#include <Behavior.h>
+#include <Level.h>
+#include <Object.h>
+
+#include <QTextStream>
+
+#include <algorithm>
+#include <chrono>
+
+using namespace Neo;
+
+void BehaviorProfiler::clear()
+{
+	m_behaviors.clear();
+	m_objects.clear();
+	m_frames = 0;
+}
+
+void BehaviorProfiler::update(LevelGameState& game, Platform& platform, float dt)
+{
+	using Clock = std::chrono::steady_clock;
+	auto& level = game.getLevel();
+
+	m_active.clear();
+	for(size_t i = 0; i < level.getObjects().size(); i++)
+	{
+		auto& object = level.getObjects()[i];
+		if(object.isActive())
+		{
+			m_active.push_back(i);
+			object.setActive(false);
+		}
+	}
+
+	auto reactivate = [this, &level]() {
+		for(auto i : m_active)
+			level.getObjects()[i].setActive(true);
+	};
+
+	try
+	{
+		game.update(platform, dt);
+	}
+	catch(...)
+	{
+		reactivate();
+		throw;
+	}
+	reactivate();
+
+	// Objects created by the level pass were already updated by it. Behaviors may
+	// create objects too, which can move the object storage, so objects are looked
+	// up by index after every call.
+	for(auto i : m_active)
+	{
+		// Deactivated by an earlier behavior of this frame
+		if(!level.getObjects()[i].isActive())
+			continue;
+
+		auto& object = m_objects[i];
+		object.name = level.getObjects()[i].getName().str();
+
+		for(size_t j = 0; j < level.getObjects()[i].getBehaviors().size(); j++)
+		{
+			Behavior* behavior = level.getObjects()[i].getBehaviors()[j].get();
+			auto& type = m_behaviors[behavior->getName()];
+			if(type.name.empty())
+				type.name = behavior->getName();
+
+			const uint64_t allocations = AllocationCounter::get();
+			const auto begin = Clock::now();
+
+			behavior->update(platform, dt);
+
+			const double ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+			const uint64_t allocated = AllocationCounter::get() - allocations;
+
+			for(Entry* e : {&type, &object})
+			{
+				e->time += ms;
+				e->calls++;
+				e->allocations += allocated;
+				e->frameTime += ms;
+			}
+		}
+	}
+
+	for(auto& e : m_behaviors)
+	{
+		e.second.maxFrameTime = std::max(e.second.maxFrameTime, e.second.frameTime);
+		e.second.frameTime = 0;
+	}
+
+	for(auto& e : m_objects)
+	{
+		e.second.maxFrameTime = std::max(e.second.maxFrameTime, e.second.frameTime);
+		e.second.frameTime = 0;
+	}
+
+	m_frames++;
+}
+
+QString BehaviorProfiler::toCsv() const
+{
+	QString csv;
+	QTextStream stream(&csv);
+	stream << "kind,id,name,update_ms,calls,allocations,max_frame_ms\n";
+
+	auto write = [&stream](const char* kind, const QString& id, const Entry& entry) {
+		// Object names are user input
+		const QString name = QString::fromStdString(entry.name).replace("\"", "\"\"");
+
+		stream << kind << "," << id << ",\"" << name << "\","
+			<< entry.time << "," << entry.calls << "," << entry.allocations << ","
+			<< entry.maxFrameTime << "\n";
+	};
+
+	for(auto& e : m_behaviors)
+		write("behavior", QString(), e.second);
+
+	for(auto& e : m_objects)
+		write("object", QString::number(e.first), e.second);
+
+	return csv;
+}
@@ -0,0 +1,75 @@
+#ifndef NEOEDITOR_BEHAVIORPROFILER_H
+#define NEOEDITOR_BEHAVIORPROFILER_H
+
+#include <LevelGameState.h>
+#include <Platform.h>
+
+#include <QString>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Neo
+{
+
+/**
+ * Measures the update of every behavior of a running game.
+ *
+ * The engine updates the behaviors inside Level::update without a hook, so
+ * while profiling the objects are switched inactive for the level pass and
+ * their behaviors are then updated in level order by the profiler, with a
+ * timer and an AllocationCounter around each call. Behaviors stay attached
+ * to their objects, so lookups from engine code keep working. The draw pass
+ * is left alone, the level draws behaviors internally while setting up the
+ * camera and lights, so it cannot be split without changing the frame.
+ *
+ * Time, calls and allocations are accumulated per behavior type and per
+ * object until clear() is called. Objects are identified by their index,
+ * which is stable while a game is running.
+ */
+class BehaviorProfiler
+{
+public:
+	struct Entry
+	{
+		std::string name; // For display, objects with the same name get their own entries
+		double time = 0; // Cumulative, in ms
+		uint64_t calls = 0;
+		uint64_t allocations = 0;
+		double maxFrameTime = 0; // In ms
+		double frameTime = 0; // Of the current frame
+	};
+
+	typedef std::unordered_map<std::string, Entry> BehaviorEntries;
+	typedef std::unordered_map<size_t, Entry> ObjectEntries;
+
+	void setEnabled(bool enabled) { m_enabled = enabled; }
+	bool isEnabled() const { return m_enabled; }
+
+	/// Needs to be called when a different game starts, objects are identified by index
+	void clear();
+
+	/// Replaces LevelGameState::update while profiling
+	void update(LevelGameState& game, Platform& platform, float dt);
+
+	const BehaviorEntries& getBehaviors() const { return m_behaviors; }
+	const ObjectEntries& getObjects() const { return m_objects; }
+	uint64_t getFrames() const { return m_frames; }
+
+	/// One line per behavior type and per object, times in ms
+	QString toCsv() const;
+
+private:
+	bool m_enabled = false;
+	uint64_t m_frames = 0;
+
+	BehaviorEntries m_behaviors;
+	ObjectEntries m_objects;
+	std::vector<size_t> m_active; // Objects switched inactive for the level pass
+};
+
+}
+
+#endif // NEOEDITOR_BEHAVIORPROFILER_H
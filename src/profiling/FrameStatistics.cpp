@@ -0,0 +1,52 @@
+#include "FrameStatistics.h"
+
+#include <QJsonArray>
+
+#include <algorithm>
+#include <numeric>
+
+FrameStatistics::Summary FrameStatistics::summarize() const
+{
+	Summary summary;
+	if(m_times.empty())
+		return summary;
+
+	std::vector<float> values = m_times;
+	std::sort(values.begin(), values.end());
+
+	auto percentile = [&values](float p) { return values[static_cast<size_t>(p * (values.size() - 1))]; };
+
+	summary.frames = values.size();
+	summary.min = values.front();
+	summary.max = values.back();
+	summary.mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+	summary.p50 = percentile(0.5f);
+	summary.p95 = percentile(0.95f);
+	summary.p99 = percentile(0.99f);
+	return summary;
+}
+
+QJsonObject FrameStatistics::toJson(bool frameTimes) const
+{
+	const auto summary = summarize();
+
+	QJsonObject json;
+	json["frames"] = static_cast<qint64>(summary.frames);
+	json["min"] = summary.min;
+	json["mean"] = summary.mean;
+	json["max"] = summary.max;
+	json["p50"] = summary.p50;
+	json["p95"] = summary.p95;
+	json["p99"] = summary.p99;
+
+	if(frameTimes)
+	{
+		QJsonArray times;
+		for(float t : m_times)
+			times.append(t);
+
+		json["frameTimes"] = times;
+	}
+
+	return json;
+}
@@ -0,0 +1,42 @@
+#ifndef NEOEDITOR_FRAMESTATISTICS_H
+#define NEOEDITOR_FRAMESTATISTICS_H
+
+#include <QJsonObject>
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Collects the frame times of a run and summarizes them for automated
+ * performance tracking. Unlike the Profiler it keeps every frame, so it is
+ * meant for runs of bounded length.
+ */
+class FrameStatistics
+{
+public:
+	struct Summary
+	{
+		size_t frames = 0;
+		float min = 0, mean = 0, max = 0; // In ms
+		float p50 = 0, p95 = 0, p99 = 0;
+	};
+
+	void reserve(size_t frames) { m_times.reserve(frames); }
+	void clear() { m_times.clear(); }
+
+	/// Adds the value of one frame, usually its time in ms
+	void add(float ms) { m_times.push_back(ms); }
+
+	size_t size() const { return m_times.size(); }
+	const std::vector<float>& getFrameTimes() const { return m_times; }
+
+	Summary summarize() const;
+
+	/// The summary and, if requested, all frame times
+	QJsonObject toJson(bool frameTimes = false) const;
+
+private:
+	std::vector<float> m_times;
+};
+
+#endif // NEOEDITOR_FRAMESTATISTICS_H
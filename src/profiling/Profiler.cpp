@@ -0,0 +1,193 @@
+#include "Profiler.h"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cstring>
+
+thread_local uint32_t Profiler::s_depth = 0;
+
+// A frame is a spike if a scope takes this much longer than its median
+static constexpr float SPIKE_FACTOR = 2.0f;
+static constexpr float SPIKE_MIN_MS = 0.5f;
+
+Profiler& Profiler::get()
+{
+	static Profiler p;
+	return p;
+}
+
+void Profiler::push(const Sample& sample)
+{
+	// Reserve a slot, drop the sample if the reader did not free one yet
+	auto index = m_head.load(std::memory_order_relaxed);
+	do
+	{
+		if(index - m_tail.load(std::memory_order_acquire) >= RING_SIZE)
+		{
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+	while(!m_head.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+
+	auto& slot = m_ring[index & (RING_SIZE - 1)];
+	slot.sample = sample;
+	slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::endFrame()
+{
+	auto tail = m_tail.load(std::memory_order_relaxed);
+	const auto head = m_head.load(std::memory_order_acquire);
+
+	for(; tail < head; tail++)
+	{
+		auto& slot = m_ring[tail & (RING_SIZE - 1)];
+
+		// Reserved but not written yet, the rest is collected next frame
+		if(slot.sequence.load(std::memory_order_acquire) != tail + 1)
+			break;
+
+		m_frameSamples.push_back(slot.sample);
+		m_tail.store(tail + 1, std::memory_order_release);
+	}
+
+	// Samples arrive when their scope is left, i.e. children before their parents.
+	// In order of entry parents come first, so new scopes can be put below them.
+	std::sort(m_frameSamples.begin(), m_frameSamples.end(), [](const Sample& a, const Sample& b) {
+		return a.begin < b.begin || (a.begin == b.begin && a.depth < b.depth);
+	});
+
+	std::vector<const Sample*> open; // Enclosing samples of the current one
+	for(auto& sample : m_frameSamples)
+	{
+		while(!open.empty() && (open.back()->depth >= sample.depth || open.back()->end < sample.end))
+			open.pop_back();
+
+		auto* scope = findScope(sample.name);
+		if(!scope)
+			scope = addScope(sample.name, open.empty() ? nullptr : open.back()->name);
+
+		scope->depth = sample.depth;
+		scope->frameTime += static_cast<float>(sample.end - sample.begin) / 1000000.0f;
+		open.push_back(&sample);
+	}
+
+	m_frameSamples.clear();
+
+	for(auto& scope : m_scopes)
+	{
+		scope.history[m_frame % HISTORY_SIZE] = scope.frameTime;
+		scope.frameTime = 0;
+	}
+
+	m_frame++;
+}
+
+Profiler::Scope* Profiler::addScope(const char* name, const char* parent)
+{
+	// Below the parent and its existing children, top level scopes go last
+	auto position = m_scopes.end();
+	if(parent)
+	{
+		auto iter = std::find_if(m_scopes.begin(), m_scopes.end(), [parent](const Scope& s) {
+			return s.name == parent || !strcmp(s.name, parent);
+		});
+
+		if(iter != m_scopes.end())
+		{
+			const auto depth = iter->depth;
+			for(iter++; iter != m_scopes.end() && iter->depth > depth; iter++);
+			position = iter;
+		}
+	}
+
+	Scope scope;
+	scope.name = name;
+	return &*m_scopes.insert(position, scope);
+}
+
+Profiler::Scope* Profiler::findScope(const char* name)
+{
+	auto iter = std::find_if(m_scopes.begin(), m_scopes.end(), [name](const Scope& s) {
+		return s.name == name || !strcmp(s.name, name);
+	});
+
+	return (iter == m_scopes.end() ? nullptr : &*iter);
+}
+
+const Profiler::Scope* Profiler::findScope(const char* name) const
+{
+	return const_cast<Profiler*>(this)->findScope(name);
+}
+
+Profiler::Statistics Profiler::computeStatistics(const Scope& scope, size_t frames)
+{
+	Statistics stats;
+	if(frames == 0)
+		return stats;
+
+	const size_t count = std::min(frames, HISTORY_SIZE);
+	std::vector<float> values(scope.history.begin(), scope.history.begin() + count);
+	std::sort(values.begin(), values.end());
+
+	auto percentile = [&values](float p) { return values[static_cast<size_t>(p * (values.size() - 1))]; };
+
+	stats.last = scope.history[(frames - 1) % HISTORY_SIZE];
+	stats.p50 = percentile(0.5f);
+	stats.p95 = percentile(0.95f);
+	stats.p99 = percentile(0.99f);
+	return stats;
+}
+
+Profiler::Statistics Profiler::getStatistics(const char* name) const
+{
+	auto* scope = findScope(name);
+	return scope ? computeStatistics(*scope, m_frame) : Statistics();
+}
+
+void Profiler::drawOverlay()
+{
+	ImGui::SetNextWindowSize(ImVec2(420, 0), ImGuiCond_FirstUseEver);
+	ImGui::Begin("Profiler");
+
+	const auto dropped = m_dropped.load(std::memory_order_relaxed);
+	if(dropped)
+		ImGui::TextColored(ImVec4(1, 0.4f, 0.4f, 1), "%llu samples dropped", static_cast<unsigned long long>(dropped));
+
+	const size_t count = std::min(m_frame, HISTORY_SIZE);
+	for(auto& scope : m_scopes)
+	{
+		const auto stats = computeStatistics(scope, m_frame);
+
+		ImGui::PushID(&scope);
+		ImGui::Indent(scope.depth * 10.0f + 1.0f);
+		ImGui::Text("%s: %.2f ms (p50 %.2f, p95 %.2f, p99 %.2f)", scope.name, stats.last, stats.p50, stats.p95, stats.p99);
+
+		// The offset makes the ring buffer show up oldest to newest
+		const int offset = (count == HISTORY_SIZE ? m_frame % HISTORY_SIZE : 0);
+		ImGui::PlotHistogram("", scope.history.data(), count, offset, nullptr, 0.0f, std::max(stats.p99 * 1.5f, 0.1f), ImVec2(-1, 32));
+
+		// Spike markers above the bars
+		const auto min = ImGui::GetItemRectMin();
+		const auto max = ImGui::GetItemRectMax();
+		const float barWidth = (max.x - min.x) / std::max<size_t>(count, 1);
+		const float threshold = std::max(stats.p50 * SPIKE_FACTOR, SPIKE_MIN_MS);
+
+		auto* drawList = ImGui::GetWindowDrawList();
+		for(size_t i = 0; i < count; i++)
+		{
+			if(scope.history[(offset + i) % HISTORY_SIZE] < threshold)
+				continue;
+
+			const float x = min.x + (i + 0.5f) * barWidth;
+			drawList->AddLine(ImVec2(x, min.y), ImVec2(x, min.y + 4), IM_COL32(255, 64, 64, 255), 2.0f);
+		}
+
+		ImGui::Unindent(scope.depth * 10.0f + 1.0f);
+		ImGui::PopID();
+	}
+
+	ImGui::End();
+}
@@ -0,0 +1,120 @@
+#ifndef NEOEDITOR_PROFILER_H
+#define NEOEDITOR_PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Hierarchical CPU profiler for the editor frame.
+ *
+ * PROFILE_SCOPE(name) measures the enclosing scope. Scopes nest, the depth
+ * is tracked per thread. Finished scopes are pushed into a fixed size lock
+ * free ring buffer, which endFrame() drains once per frame into a rolling
+ * history per scope. drawOverlay() shows the history as ImGui histograms with
+ * percentiles and marks spikes.
+ *
+ * Scopes are only compiled in with the ENABLE_PROFILER CMake option
+ * (NEO_PROFILER), otherwise PROFILE_SCOPE expands to nothing.
+ */
+class Profiler
+{
+public:
+	/// Scope names need to be string literals or otherwise outlive the profiler
+	struct Sample
+	{
+		const char* name = nullptr;
+		uint32_t depth = 0;
+		uint64_t begin = 0, end = 0; // In ns
+	};
+
+	struct Statistics
+	{
+		float last = 0, p50 = 0, p95 = 0, p99 = 0; // In ms
+	};
+
+	static constexpr size_t RING_SIZE = 4096; // Power of two
+	static constexpr size_t HISTORY_SIZE = 240; // Frames
+
+	static Profiler& get();
+	static uint64_t now()
+	{
+		using namespace std::chrono;
+		return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+	}
+
+	/// Can be called from any thread
+	void push(const Sample& sample);
+
+	/// Collects the samples of the last frame, call once per frame on the GUI thread
+	void endFrame();
+
+	/// Draws the profiler window, needs to be called between ImGui::NewFrame and ImGui::Render
+	void drawOverlay();
+
+	Statistics getStatistics(const char* name) const;
+
+	static thread_local uint32_t s_depth;
+
+private:
+	struct Slot
+	{
+		std::atomic<uint64_t> sequence{0}; // Index + 1 of the sample in the slot once it is written
+		Sample sample;
+	};
+
+	struct Scope
+	{
+		const char* name = nullptr;
+		uint32_t depth = 0;
+		std::array<float, HISTORY_SIZE> history = {}; // Time per frame in ms
+		float frameTime = 0; // Sum of the current frame
+	};
+
+	Scope* findScope(const char* name);
+	Scope* addScope(const char* name, const char* parent);
+	const Scope* findScope(const char* name) const;
+	static Statistics computeStatistics(const Scope& scope, size_t frames);
+
+	std::array<Slot, RING_SIZE> m_ring;
+	std::atomic<uint64_t> m_head{0}; // Next index to write
+	std::atomic<uint64_t> m_tail{0}; // Next index to read, slots before it can be reused
+	std::atomic<uint64_t> m_dropped{0}; // Samples which did not fit into the ring
+
+	std::vector<Scope> m_scopes; // Depth first, children below their parents
+	std::vector<Sample> m_frameSamples; // Collected by endFrame()
+	size_t m_frame = 0; // Number of frames collected
+};
+
+/// Measures the time until the end of the enclosing scope
+class ProfileScope
+{
+	Profiler::Sample m_sample;
+
+public:
+	explicit ProfileScope(const char* name)
+	{
+		m_sample.name = name;
+		m_sample.depth = Profiler::s_depth++;
+		m_sample.begin = Profiler::now();
+	}
+
+	~ProfileScope()
+	{
+		m_sample.end = Profiler::now();
+		Profiler::s_depth--;
+		Profiler::get().push(m_sample);
+	}
+};
+
+#ifdef NEO_PROFILER
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+#endif // NEOEDITOR_PROFILER_H
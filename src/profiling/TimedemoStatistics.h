@@ -0,0 +1,87 @@
+#ifndef NEOEDITOR_TIMEDEMOSTATISTICS_H
+#define NEOEDITOR_TIMEDEMOSTATISTICS_H
+
+#include "FrameStatistics.h"
+
+#include <QJsonArray>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+/**
+ * Frame times and renderer counters of a reproducible run. The counters
+ * tell whether a change in frame time comes from drawing more.
+ */
+class TimedemoStatistics
+{
+public:
+	void reserve(size_t frames)
+	{
+		m_frameTimes.reserve(frames);
+		m_drawCalls.reserve(frames);
+		m_triangles.reserve(frames);
+	}
+
+	void clear()
+	{
+		m_frameTimes.clear();
+		m_drawCalls.clear();
+		m_triangles.clear();
+	}
+
+	void addFrame(float ms, unsigned int drawCalls, unsigned int triangles)
+	{
+		m_frameTimes.add(ms);
+		m_drawCalls.push_back(drawCalls);
+		m_triangles.push_back(triangles);
+	}
+
+	size_t size() const { return m_frameTimes.size(); }
+	const FrameStatistics& getFrameTimes() const { return m_frameTimes; }
+
+	QJsonObject toJson() const
+	{
+		QJsonObject json;
+		json["frameTime"] = m_frameTimes.toJson(true);
+		json["drawCalls"] = counterJson(m_drawCalls);
+		json["triangles"] = counterJson(m_triangles);
+		return json;
+	}
+
+private:
+	/// Counters are exact integers unlike times, e.g. triangle counts can exceed the precision of a float
+	static QJsonObject counterJson(const std::vector<uint32_t>& counts)
+	{
+		QJsonObject json;
+		json["frames"] = static_cast<qint64>(counts.size());
+		if(counts.empty())
+			return json;
+
+		std::vector<uint32_t> sorted = counts;
+		std::sort(sorted.begin(), sorted.end());
+
+		auto percentile = [&sorted](double p) { return static_cast<qint64>(sorted[static_cast<size_t>(p * (sorted.size() - 1))]); };
+		const uint64_t total = std::accumulate(sorted.begin(), sorted.end(), uint64_t(0));
+
+		json["total"] = static_cast<qint64>(total);
+		json["min"] = static_cast<qint64>(sorted.front());
+		json["mean"] = static_cast<double>(total) / sorted.size();
+		json["max"] = static_cast<qint64>(sorted.back());
+		json["p50"] = percentile(0.5);
+		json["p95"] = percentile(0.95);
+
+		QJsonArray perFrame;
+		for(auto count : counts)
+			perFrame.append(static_cast<qint64>(count));
+
+		json["perFrame"] = perFrame;
+		return json;
+	}
+
+	FrameStatistics m_frameTimes;
+	std::vector<uint32_t> m_drawCalls, m_triangles;
+};
+
+#endif // NEOEDITOR_TIMEDEMOSTATISTICS_H
@@ -0,0 +1,196 @@
+#include "Trace.h"
+
+#include <Log.h>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+
+#include <chrono>
+
+static QString escape(const std::string& str)
+{
+	QString result;
+	for(QChar c : QString::fromStdString(str))
+	{
+		switch(c.unicode())
+		{
+		case '"': result += "\\\""; break;
+		case '\\': result += "\\\\"; break;
+		case '\n': result += "\\n"; break;
+		case '\t': result += "\\t"; break;
+		default:
+			if(c.unicode() < 0x20)
+				result += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+			else
+				result += c;
+		}
+	}
+
+	return result;
+}
+
+Trace& Trace::get()
+{
+	static Trace t;
+	return t;
+}
+
+int64_t Trace::now()
+{
+	using namespace std::chrono;
+	return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+bool Trace::start(const QString& file)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if(m_running)
+		return false;
+
+	m_file = file;
+	m_events.clear();
+	m_running = true;
+
+	LOG_INFO("Started trace capture: " << file.toStdString());
+	return true;
+}
+
+bool Trace::stop()
+{
+	std::vector<Event> events;
+	std::unordered_map<uint32_t, std::string> threadNames;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if(!m_running)
+			return false;
+
+		m_running = false;
+		events.swap(m_events);
+		threadNames = m_threadNames;
+	}
+
+	QFile f(m_file);
+	if(!f.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+	{
+		LOG_ERROR("Could not write trace: " << m_file.toStdString());
+		return false;
+	}
+
+	const auto pid = QCoreApplication::applicationPid();
+	QTextStream out(&f);
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+	bool first = true;
+	for(auto& name : threadNames)
+	{
+		out << (first ? "" : ",\n")
+			<< "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << name.first
+			<< ",\"args\":{\"name\":\"" << escape(name.second) << "\"}}";
+		first = false;
+	}
+
+	for(auto& e : events)
+	{
+		out << (first ? "" : ",\n")
+			<< "{\"ph\":\"" << e.phase << "\",\"pid\":" << pid << ",\"tid\":" << e.thread << ",\"ts\":" << e.timestamp;
+		first = false;
+
+		if(e.phase != 'E')
+			out << ",\"name\":\"" << escape(e.name) << "\",\"cat\":\"editor\"";
+
+		if(e.phase == 'X')
+			out << ",\"dur\":" << e.duration;
+
+		if(e.phase == 'C')
+			out << ",\"args\":{\"value\":" << e.value << "}";
+		else if(!e.detail.empty())
+			out << ",\"args\":{\"detail\":\"" << escape(e.detail) << "\"}";
+
+		out << "}";
+	}
+
+	out << "\n]}\n";
+
+	LOG_INFO("Wrote " << events.size() << " trace events to " << m_file.toStdString());
+	return true;
+}
+
+void Trace::begin(const char* name, const std::string& detail)
+{
+	if(!isRunning())
+		return;
+
+	Event e;
+	e.phase = 'B';
+	e.name = name;
+	e.detail = detail;
+	push(std::move(e));
+}
+
+void Trace::end()
+{
+	if(!isRunning())
+		return;
+
+	Event e;
+	e.phase = 'E';
+	push(std::move(e));
+}
+
+void Trace::complete(const std::string& name, int64_t begin, int64_t end)
+{
+	if(!isRunning())
+		return;
+
+	Event e;
+	e.phase = 'X';
+	e.name = name;
+	e.timestamp = begin;
+	e.duration = end - begin;
+	push(std::move(e));
+}
+
+void Trace::counter(const char* name, double value)
+{
+	if(!isRunning())
+		return;
+
+	Event e;
+	e.phase = 'C';
+	e.name = name;
+	e.value = value;
+	push(std::move(e));
+}
+
+void Trace::setThreadName(const std::string& name)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_threadNames[threadIndex()] = name;
+}
+
+uint32_t Trace::threadIndex()
+{
+	auto iter = m_threads.find(std::this_thread::get_id());
+	if(iter != m_threads.end())
+		return iter->second;
+
+	const uint32_t index = m_threads.size() + 1;
+	m_threads[std::this_thread::get_id()] = index;
+	return index;
+}
+
+void Trace::push(Event&& event)
+{
+	if(event.phase != 'X')
+		event.timestamp = now();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// The capture might have been stopped meanwhile
+	if(!m_running)
+		return;
+
+	event.thread = threadIndex();
+	m_events.push_back(std::move(event));
+}
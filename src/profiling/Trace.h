@@ -0,0 +1,97 @@
+#ifndef NEOEDITOR_TRACE_H
+#define NEOEDITOR_TRACE_H
+
+#include <QString>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Records spans and counters of editor operations while a capture is running
+ * and writes them as Chrome trace JSON, which can be opened in Perfetto or
+ * chrome://tracing.
+ *
+ * Spans are begin/end pairs per thread, use TRACE_SCOPE for the common case.
+ * Operations which do not nest on one thread (e.g. asynchronous build steps)
+ * can be added with complete() once they are done. When no capture is
+ * running all calls return after checking a flag.
+ */
+class Trace
+{
+public:
+	static Trace& get();
+
+	/// Microseconds on the trace clock
+	static int64_t now();
+
+	/// Starts collecting events, they are written to the file by stop()
+	bool start(const QString& file);
+	bool stop();
+
+	bool isRunning() const { return m_running.load(std::memory_order_relaxed); }
+	const QString& getFile() const { return m_file; }
+
+	void begin(const char* name, const std::string& detail = std::string());
+	void end();
+
+	/// Adds a finished span with explicit timestamps
+	void complete(const std::string& name, int64_t begin, int64_t end);
+	void counter(const char* name, double value);
+
+	/// Names the calling thread in the trace
+	void setThreadName(const std::string& name);
+
+private:
+	struct Event
+	{
+		char phase;
+		std::string name;
+		std::string detail;
+		int64_t timestamp = 0;
+		int64_t duration = 0;
+		double value = 0;
+		uint32_t thread = 0;
+	};
+
+	uint32_t threadIndex(); // Expects m_mutex to be locked
+	void push(Event&& event);
+
+	std::atomic<bool> m_running{false};
+	QString m_file;
+
+	std::mutex m_mutex;
+	std::vector<Event> m_events;
+	std::unordered_map<std::thread::id, uint32_t> m_threads;
+	std::unordered_map<uint32_t, std::string> m_threadNames;
+};
+
+/// Traces the enclosing scope while a capture is running
+class TraceScope
+{
+	bool m_active;
+
+public:
+	explicit TraceScope(const char* name, const std::string& detail = std::string()):
+		m_active(Trace::get().isRunning())
+	{
+		if(m_active)
+			Trace::get().begin(name, detail);
+	}
+
+	~TraceScope()
+	{
+		if(m_active)
+			Trace::get().end();
+	}
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(...) TraceScope TRACE_CONCAT(traceScope, __LINE__)(__VA_ARGS__)
+
+#endif // NEOEDITOR_TRACE_H
@@ -0,0 +1,211 @@
+#include "BuildService.h"
+
+#include <QRegularExpression>
+#include <Log.h>
+#include <profiling/Trace.h>
+
+// file:line:column: error: message (GCC and Clang)
+static const QRegularExpression s_gccDiagnostic("^(.+?):(\\d+):(\\d+): (fatal error|error|warning|note): (.*)$");
+
+// file(line,column): error C1234: message (MSVC)
+static const QRegularExpression s_msvcDiagnostic("^(.+?)\\((\\d+)(?:,(\\d+))?\\): (fatal error|error|warning) \\w+: (.*)$");
+
+// [ 42%] Building ... (Makefiles) and [12/34] Building ... (Ninja)
+static const QRegularExpression s_percentProgress("^\\[\\s*(\\d+)%\\]");
+static const QRegularExpression s_countProgress("^\\[(\\d+)/(\\d+)\\]");
+
+BuildService::BuildService(QObject* parent):
+	QObject(parent)
+{
+	qRegisterMetaType<BuildIssue>();
+
+	m_process.setProcessChannelMode(QProcess::MergedChannels);
+	connect(&m_process, &QProcess::readyRead, this, &BuildService::readOutput);
+	connect(&m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, &BuildService::processFinished);
+	connect(&m_process, &QProcess::errorOccurred, [this](QProcess::ProcessError error) {
+		// Finished is not emitted if the process could not be started at all
+		if(error == QProcess::FailedToStart)
+		{
+			LOG_ERROR("Could not start " << m_process.program().toStdString());
+			finish(false);
+		}
+	});
+}
+
+BuildService::~BuildService()
+{
+	// Nobody is interested in the result anymore
+	m_done = nullptr;
+	m_steps.clear();
+	m_process.disconnect(this);
+
+	if(m_process.state() != QProcess::NotRunning)
+	{
+		m_process.kill();
+		m_process.waitForFinished();
+	}
+}
+
+bool BuildService::run(std::vector<Step> steps, std::function<void(bool)> done)
+{
+	if(m_running)
+	{
+		LOG_WARNING("A build is already running!");
+		return false;
+	}
+
+	m_steps.assign(steps.begin(), steps.end());
+	m_done = done;
+	m_issues.clear();
+	m_running = true;
+	m_cancelled = false;
+
+	emit started();
+	runNext();
+	return true;
+}
+
+void BuildService::cancel()
+{
+	if(!m_running)
+		return;
+
+	LOG_INFO("Cancelling build");
+	m_steps.clear();
+	m_cancelled = true;
+
+	// Wait so the callbacks are done when this returns and the project can go away
+	if(m_process.state() != QProcess::NotRunning)
+	{
+		m_process.kill();
+		m_process.waitForFinished();
+	}
+
+	if(m_running)
+		finish(false);
+}
+
+void BuildService::runNext()
+{
+	if(m_steps.empty())
+	{
+		finish(true);
+		return;
+	}
+
+	auto step = std::move(m_steps.front());
+	m_steps.pop_front();
+
+	LOG_INFO(step.description.toStdString());
+	emit stepStarted(step.description);
+	emit progress(0);
+
+	m_stepDone = step.onSuccess;
+	m_stepDescription = step.description;
+	m_stepTimer.start();
+	m_stepBegin = Trace::now();
+
+	m_process.setWorkingDirectory(step.workingDirectory);
+	m_process.start(step.program, step.arguments);
+}
+
+void BuildService::finish(bool success)
+{
+	m_running = false;
+	m_stepDone = nullptr;
+
+	auto done = std::move(m_done);
+	m_done = nullptr;
+
+	if(done)
+		done(success);
+
+	emit finished(success);
+}
+
+void BuildService::readOutput()
+{
+	while(m_process.canReadLine())
+	{
+		auto line = QString::fromUtf8(m_process.readLine()).trimmed();
+		if(line.isEmpty())
+			continue;
+
+		LOG_INFO(line.toStdString());
+		parseLine(line);
+	}
+}
+
+void BuildService::processFinished(int exitCode, QProcess::ExitStatus status)
+{
+	// Read what is left, the last line might miss its line break
+	readOutput();
+	const auto rest = QString::fromUtf8(m_process.readAll()).trimmed();
+	if(!rest.isEmpty())
+	{
+		LOG_INFO(rest.toStdString());
+		parseLine(rest);
+	}
+
+	// Build steps run asynchronously, so they do not nest with other spans
+	Trace::get().complete(m_stepDescription.toStdString(), m_stepBegin, Trace::now());
+
+	if(m_cancelled || status != QProcess::NormalExit || exitCode != 0)
+	{
+		if(!m_cancelled)
+			LOG_ERROR(m_process.program().toStdString() << " failed with exit code " << exitCode);
+
+		finish(false);
+		return;
+	}
+
+	LOG_INFO(m_stepDescription.toStdString() << " took " << m_stepTimer.elapsed() << "ms");
+
+	if(m_stepDone)
+		m_stepDone();
+
+	runNext();
+}
+
+void BuildService::parseLine(const QString& line)
+{
+	auto match = s_percentProgress.match(line);
+	if(match.hasMatch())
+	{
+		emit progress(match.captured(1).toInt());
+		return;
+	}
+
+	match = s_countProgress.match(line);
+	if(match.hasMatch())
+	{
+		const int total = match.captured(2).toInt();
+		if(total > 0)
+			emit progress(match.captured(1).toInt() * 100 / total);
+		return;
+	}
+
+	match = s_gccDiagnostic.match(line);
+	if(!match.hasMatch())
+		match = s_msvcDiagnostic.match(line);
+
+	if(!match.hasMatch())
+		return;
+
+	BuildIssue issue;
+	issue.file = match.captured(1);
+	issue.line = match.captured(2).toInt();
+	issue.column = match.captured(3).toInt();
+	issue.message = match.captured(5);
+
+	const auto severity = match.captured(4);
+	if(severity == "warning")
+		issue.severity = BuildIssue::ISSUE_WARNING;
+	else if(severity == "note")
+		issue.severity = BuildIssue::ISSUE_NOTE;
+	else
+		issue.severity = BuildIssue::ISSUE_ERROR;
+
+	m_issues.push_back(issue);
+	emit issueFound(issue);
+}
@@ -0,0 +1,102 @@
+#ifndef BUILDSERVICE_H
+#define BUILDSERVICE_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+/**
+ * A compiler diagnostic parsed from the build output.
+ */
+struct BuildIssue
+{
+	enum SEVERITY
+	{
+		ISSUE_ERROR,
+		ISSUE_WARNING,
+		ISSUE_NOTE
+	};
+
+	SEVERITY severity = ISSUE_ERROR;
+	QString file;
+	int line = 0;
+	int column = 0;
+	QString message;
+};
+
+/**
+ * Runs build steps (configure, build, ...) one after another in the background.
+ *
+ * Everything is driven by QProcess signals, so the UI stays responsive.
+ * The output is logged, diagnostics and progress are parsed and reported
+ * through signals while the build is running.
+ */
+class BuildService : public QObject
+{
+	Q_OBJECT;
+public:
+	struct Step
+	{
+		QString description;
+		QString program;
+		QStringList arguments;
+		QString workingDirectory;
+
+		/// Called after the step finished successfully, before the next one starts
+		std::function<void()> onSuccess;
+	};
+
+	BuildService(QObject* parent = nullptr);
+	~BuildService();
+
+	/**
+	 * Starts running the given steps.
+	 * @param done Called with the result after the last step or the first failure.
+	 * @return false if a build is running already, done will not be called then.
+	 */
+	bool run(std::vector<Step> steps, std::function<void(bool)> done);
+
+	bool isRunning() const { return m_running; }
+	const std::vector<BuildIssue>& getIssues() const { return m_issues; }
+
+public slots:
+	/// Stops the build, the done callback has been called when this returns
+	void cancel();
+
+signals:
+	void started();
+	void stepStarted(QString description);
+	void progress(int percent);
+	void issueFound(BuildIssue issue);
+	void finished(bool success);
+
+private slots:
+	void readOutput();
+	void processFinished(int exitCode, QProcess::ExitStatus status);
+
+private:
+	void runNext();
+	void finish(bool success);
+	void parseLine(const QString& line);
+
+	QProcess m_process;
+	std::deque<Step> m_steps;
+	std::function<void()> m_stepDone;
+	QString m_stepDescription;
+	QElapsedTimer m_stepTimer;
+	int64_t m_stepBegin = 0; // On the trace clock
+	std::function<void(bool)> m_done;
+	std::vector<BuildIssue> m_issues;
+	bool m_running = false;
+	bool m_cancelled = false;
+};
+
+Q_DECLARE_METATYPE(BuildIssue)
+
+#endif // BUILDSERVICE_H
@@ -4,39 +4,91 @@
 #include <thread>
 
 #include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
 #include <QApplication>
-#include <QProcess>
+#include <QCryptographicHash>
+#include <QRegularExpression>
+#include <QStandardPaths>
 #include <QtSql/QtSql>
 
 #include <FileTools.h>
 #include <Log.h>
+#include <profiling/Trace.h>
 #include <LevelGameState.h>
 #include <Behavior.h>
 
-static void runProcess(const QString& exe, const QStringList& args, const QString& workingDirectory = "")
+static QByteArray hashFile(const QString& file)
 {
-	QProcess process;
-	
-	if(!workingDirectory.isEmpty())
-		process.setWorkingDirectory(workingDirectory);
-	
-	process.setReadChannelMode(QProcess::ProcessChannelMode::MergedChannels);
-	process.start(exe, args);
-	process.waitForStarted();
-	
-	while(process.state() == QProcess::Running || process.canReadLine())
+	QFile f(file);
+	if(!f.open(QIODevice::ReadOnly))
+		return QByteArray();
+
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	hash.addData(&f);
+	return hash.result();
+}
+
+// Everything CMake reads itself, changes require a new configure run
+static bool isBuildScript(const QString& file)
+{
+	return file.endsWith("CMakeLists.txt") || file.endsWith(".cmake") || file.endsWith(".in");
+}
+
+// Returns all files below dir relative to it, sorted so the fingerprints are stable
+static QStringList listFiles(const QString& dir)
+{
+	QStringList files;
+	QDirIterator iter(dir, QDir::Files, QDirIterator::Subdirectories);
+	while(iter.hasNext())
+		files << QDir(dir).relativeFilePath(iter.next());
+
+	files.sort();
+	return files;
+}
+
+// Logs the time spent per target since the given position in the Ninja log.
+// Ninja appends one "start end mtime output hash" line per built output.
+static void reportTargetTimes(const QString& ninjaLog, qint64 offset)
+{
+	QFile file(ninjaLog);
+	if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return;
+
+	// The log is rewritten from time to time, start over then
+	if(offset > file.size())
+		offset = 0;
+
+	file.seek(offset);
+
+	struct Timing
 	{
-		if(process.canReadLine())
-		{
-			std::string line = process.readLine().data();
-			line.pop_back();
-			
-			if(!line.empty())
-				LOG_INFO(line);
-		}
-		
-		QApplication::processEvents();
+		int outputs = 0;
+		qint64 milliseconds = 0;
+	};
+
+	// Object files are built in CMakeFiles/<target>.dir, everything else is reported by its name
+	static const QRegularExpression objectOutput("CMakeFiles/([^/]+)\\.dir/");
+	QMap<QString, Timing> targets;
+
+	while(!file.atEnd())
+	{
+		const auto line = QString::fromUtf8(file.readLine()).trimmed();
+		if(line.startsWith('#'))
+			continue;
+
+		const auto fields = line.split('\t');
+		if(fields.size() < 4)
+			continue;
+
+		const auto match = objectOutput.match(fields[3]);
+		auto& timing = targets[match.hasMatch() ? match.captured(1) : QFileInfo(fields[3]).fileName()];
+		timing.outputs++;
+		timing.milliseconds += fields[1].toLongLong() - fields[0].toLongLong();
 	}
+
+	for(auto iter = targets.begin(); iter != targets.end(); iter++)
+		LOG_INFO("Target " << iter.key().toStdString() << ": " << iter->outputs << " outputs, " << iter->milliseconds << "ms");
 }
 
 QString Project::buildDirectory(const QString& buildType)
@@ -64,19 +116,125 @@ Project Project::create(const char* name)
 	createDirectory("assets");
 	copyDirectory((appDir + QDir::separator() + "assets" + QDir::separator() + "glsl").toUtf8().data(), 
 		      (QString(name) + QDir::separator() + "assets").toUtf8().data());
-		
-	project.buildDebug();
 	
 	return project;
 }
 	
-void Project::buildDebug()
+QString Project::pluginFile() const
 {
-	// Configure, this also ensures all files have been globbed
+	return m_plugin.fileName();
+}
+
+QByteArray Project::configureFingerprint(const QString& buildType)
+{
+	// The file list is part of it since sources are globbed when configuring
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	const QString source = "source";
+	for(auto& file : listFiles(source))
+	{
+		hash.addData(file.toUtf8());
+		if(isBuildScript(file))
+			hash.addData(hashFile(source + QDir::separator() + file));
+	}
+
+	hash.addData(hashFile(buildDirectory(buildType) + QDir::separator() + "CMakeCache.txt"));
+	return hash.result().toHex();
+}
+
+QByteArray Project::sourceFingerprint()
+{
+	QCryptographicHash hash(QCryptographicHash::Md5);
+	const QString source = "source";
+	for(auto& file : listFiles(source))
+	{
+		if(isBuildScript(file))
+			continue;
+
+		hash.addData(file.toUtf8());
+		hash.addData(hashFile(source + QDir::separator() + file));
+	}
+
+	return hash.result().toHex();
+}
+
+QString Project::getVariable(const QString& key)
+{
+	QSqlQuery query(m_db);
+	query.prepare("select value from Variables where key = ?");
+	query.addBindValue(key);
+
+	if(!query.exec() || !query.next())
+		return QString();
+
+	return query.value(0).toString();
+}
+
+void Project::setVariable(const QString& key, const QString& value)
+{
+	QSqlQuery query(m_db);
+	query.prepare("insert or replace into Variables (key, value) values (?, ?)");
+	query.addBindValue(key);
+	query.addBindValue(value);
+
+	if(!query.exec())
+		LOG_WARNING("Could not store project variable " << key.toStdString() << ": " << query.lastError().text().toStdString());
+}
+	
+bool Project::buildDebug(BuildService& service, std::function<void(bool)> done)
+{
+	TRACE_SCOPE("Check game plugin fingerprints");
 	enableCurrentDirectory();
-	configure("Debug");
-	runProcess("cmake", QStringList() << "--build" << buildDirectory("Debug") << "--parallel" << std::to_string(std::thread::hardware_concurrency() + 1).c_str());
-	reloadPlugin();
+
+	const QString configureKey = "fingerprint.configure.Debug";
+	const QString sourceKey = "fingerprint.source.Debug";
+	std::vector<BuildService::Step> steps;
+
+	// Configure only if build scripts or the set of files changed, this also ensures all files have been globbed
+	const bool needsConfigure = configureFingerprint("Debug") != getVariable(configureKey).toUtf8();
+	if(needsConfigure)
+	{
+		auto step = configureStep("Debug");
+		step.onSuccess = [this, configureKey, sourceKey]() {
+			// Configuring writes the cache, so take the fingerprint afterwards
+			setVariable(configureKey, configureFingerprint("Debug"));
+			setVariable(sourceKey, QString());
+		};
+
+		steps.push_back(step);
+	}
+
+	const auto sources = sourceFingerprint();
+	if(needsConfigure || sources != getVariable(sourceKey).toUtf8() || !QFile::exists(pluginFile()))
+	{
+		BuildService::Step step;
+		step.description = "Building game plugin";
+		step.program = "cmake";
+		step.arguments << "--build" << buildDirectory("Debug") << "--parallel" << QString::number(std::thread::hardware_concurrency() + 1);
+		const auto ninjaLog = buildDirectory("Debug") + QDir::separator() + ".ninja_log";
+		const auto logOffset = QFileInfo(ninjaLog).size();
+		step.onSuccess = [this, sourceKey, sources, ninjaLog, logOffset]() {
+			setVariable(sourceKey, sources);
+			reportTargetTimes(ninjaLog, logOffset);
+		};
+
+		steps.push_back(step);
+	}
+	else
+	{
+		LOG_INFO("Game plugin is up to date");
+	}
+
+	return service.run(steps, [this, done](bool success) {
+		if(!success)
+			LOG_ERROR("Could not build game plugin!");
+
+		// Only reload if the binary is actually different
+		else if(!m_plugin.isLoaded() || hashFile(pluginFile()) != m_pluginHash)
+			reloadPlugin();
+
+		if(done)
+			done(success);
+	});
 }
 
 void Project::publish()
@@ -86,13 +244,24 @@ void Project::publish()
 
 void Project::reloadPlugin()
 {
+	TRACE_SCOPE("Reload game plugin", pluginFile().toStdString());
 	if(m_plugin.isLoaded())
 	{
-		for(unsigned int i = m_behaviorIdxEnd; i >= m_behaviorIdxStart; i--)
+		if(m_pluginUnloading)
 		{
-			Neo::Behavior::unregisterBehavior(i);
+			std::vector<std::string> names;
+			auto& registered = Neo::Behavior::registeredBehaviors();
+			for(size_t i = m_behaviorIdxStart; i < m_behaviorIdxEnd; i++)
+				names.push_back(registered[i]->getName());
+
+			m_pluginUnloading(names);
 		}
+
+		// Back to front so the indices stay valid
+		for(size_t i = m_behaviorIdxEnd; i-- > m_behaviorIdxStart;)
+			Neo::Behavior::unregisterBehavior(i);
 		
+		m_behaviorIdxStart = m_behaviorIdxEnd = 0;
 		m_game = nullptr;
 		m_plugin.unload();
 	}
@@ -112,6 +281,7 @@ void Project::reloadPlugin()
 	
 	std::vector<Neo::Behavior*> behaviors;
 	m_game = start(behaviors);
+	m_pluginHash = hashFile(pluginFile());
 	
 	m_behaviorIdxStart = Neo::Behavior::registeredBehaviors().size();
 	for(auto* behavior : behaviors)
@@ -119,9 +289,12 @@ void Project::reloadPlugin()
 		if(!Neo::Behavior::isBehaviorRegistered(behavior->getName()))
 			Neo::Behavior::registerBehavior(std::unique_ptr<Neo::Behavior>(behavior));
 	}
-	m_behaviorIdxEnd = Neo::Behavior::registeredBehaviors().size() - 1;
+	m_behaviorIdxEnd = Neo::Behavior::registeredBehaviors().size();
 	
 	LOG_INFO("Plugin loaded");
+
+	if(m_pluginLoaded)
+		m_pluginLoaded();
 }
 
 void Project::load(const char* location, bool create)
@@ -145,7 +318,7 @@ void Project::load(const char* location, bool create)
 	m_plugin.setFileName(buildDirectory("Debug") + QDir::separator() + "lib" + QDir::separator() + "libGamePlugin.so");
 }
 
-void Project::configure(const QString& buildType)
+BuildService::Step Project::configureStep(const QString& buildType)
 {
 	enableCurrentDirectory();
 	const auto buildDirectoryStr = buildDirectory(buildType);
@@ -156,13 +329,28 @@ void Project::configure(const QString& buildType)
 	
 	LOG_INFO("Using Neo installation at: " << prefixPath.toUtf8().data());
 	
-	runProcess("cmake", QStringList() 
+	BuildService::Step step;
+	step.description = "Configuring game plugin";
+	step.program = "cmake";
+	step.workingDirectory = buildDirectoryStr;
+	step.arguments
 			<< "../source" 
 			<< prefixPath
 			<< "-DCMAKE_EXPORT_COMPILE_COMMANDS=TRUE" 
 			<< "-DDISABLE_MULTITHREAD=TRUE" 
 			<< "-DNEO_PLUGIN=TRUE" 
-			<< "-DCMAKE_BUILD_TYPE=" + buildType
-			<< "-DCMAKE_C_COMPILER=clang"
-			<< "-DCMAKE_CXX_COMPILER=clang++", buildDirectoryStr);
+			<< "-DNEO_FAST_ITERATION=" + QString(buildType == "Debug" ? "ON" : "OFF")
+			<< "-DCMAKE_BUILD_TYPE=" + buildType;
+
+	// Generator and compiler can only be chosen when the build directory is new
+	if(!QFile::exists(buildDirectoryStr + QDir::separator() + "CMakeCache.txt"))
+	{
+		if(!QStandardPaths::findExecutable("ninja").isEmpty())
+			step.arguments << "-G" << "Ninja";
+
+		if(!QStandardPaths::findExecutable("clang++").isEmpty())
+			step.arguments << "-DCMAKE_C_COMPILER=clang" << "-DCMAKE_CXX_COMPILER=clang++";
+	}
+
+	return step;
 }
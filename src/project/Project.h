@@ -4,6 +4,12 @@
 #include <QtSql/QSqlDatabase>
 #include <QLibrary>
 
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "BuildService.h"
+
 namespace Neo { class LevelGameState; }
 
 class Project
@@ -13,10 +19,22 @@ class Project
 	QString m_name;
 	
 	QString buildDirectory(const QString& buildType);
+	QString pluginFile() const;
+
+	// Fingerprints decide which build steps can be skipped
+	QByteArray configureFingerprint(const QString& buildType);
+	QByteArray sourceFingerprint();
+
+	QString getVariable(const QString& key);
+	void setVariable(const QString& key, const QString& value);
 	
-	size_t m_behaviorIdxStart = 0, m_behaviorIdxEnd = 0;
+	size_t m_behaviorIdxStart = 0, m_behaviorIdxEnd = 0; // Registered plugin behaviors, the end is exclusive
+	QByteArray m_pluginHash; // Hash of the currently loaded plugin binary
 	
 	Neo::LevelGameState* m_game = nullptr;
+
+	std::function<void(const std::vector<std::string>&)> m_pluginUnloading;
+	std::function<void()> m_pluginLoaded;
 	
 public:
 	/**
@@ -33,10 +51,28 @@ public:
 	}
 	
 	void reloadPlugin();
+
+	/**
+	 * Allows keeping the live instances of plugin behaviors across a reload.
+	 * @param unloading Called with the names of the plugin behaviors right before the old library is unloaded.
+	 * @param loaded Called after the new library was loaded and its behaviors were registered.
+	 */
+	void setReloadCallbacks(std::function<void(const std::vector<std::string>&)> unloading, std::function<void()> loaded)
+	{
+		m_pluginUnloading = unloading;
+		m_pluginLoaded = loaded;
+	}
 	void load(const char* location, bool create = false);
 	
-	void configure(const QString& buildType = "Release");
-	void buildDebug();
+	BuildService::Step configureStep(const QString& buildType = "Release");
+
+	/**
+	 * Configures, builds and reloads the game plugin in the background, skipping
+	 * steps which are up to date.
+	 * @param done Called with the result once the plugin is loaded or the build failed.
+	 * @return false if the service is busy with another build.
+	 */
+	bool buildDebug(BuildService& service, std::function<void(bool)> done = nullptr);
 	void publish();
 	
 	void enableCurrentDirectory();
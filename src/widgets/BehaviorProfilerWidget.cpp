@@ -0,0 +1,182 @@
+#include "BehaviorProfilerWidget.h"
+
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+using namespace Neo;
+
+namespace
+{
+
+constexpr int REFRESH_INTERVAL = 500; // In ms
+
+QTableWidgetItem* numberItem(double value)
+{
+	auto* item = new QTableWidgetItem;
+
+	// Numbers as display data so the columns sort numerically
+	item->setData(Qt::DisplayRole, value);
+	item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+	return item;
+}
+
+}
+
+BehaviorProfilerWidget::BehaviorProfilerWidget(QWidget* parent):
+	QWidget(parent)
+{
+	auto* layout = new QVBoxLayout(this);
+	layout->setContentsMargins(0, 0, 0, 0);
+	layout->setSpacing(0);
+
+	auto* toolbar = new QHBoxLayout;
+	layout->addLayout(toolbar);
+
+	m_profileButton = new QToolButton(this);
+	m_profileButton->setText(tr("Profile"));
+	m_profileButton->setToolTip(tr("Measure the update of every behavior while the game is playing"));
+	m_profileButton->setCheckable(true);
+	toolbar->addWidget(m_profileButton);
+
+	m_grouping = new QComboBox(this);
+	m_grouping->addItem(tr("By Behavior"));
+	m_grouping->addItem(tr("By Object"));
+	toolbar->addWidget(m_grouping);
+
+	auto* resetButton = new QToolButton(this);
+	resetButton->setText(tr("Reset"));
+	toolbar->addWidget(resetButton);
+
+	auto* exportButton = new QToolButton(this);
+	exportButton->setText(tr("Export..."));
+	toolbar->addWidget(exportButton);
+
+	m_frames = new QLabel(this);
+	toolbar->addWidget(m_frames);
+	toolbar->addStretch();
+
+	m_table = new QTableWidget(0, COLUMN_COUNT, this);
+	m_table->setHorizontalHeaderLabels({
+		tr("Name"),
+		tr("Update (ms)"), tr("Calls"), tr("Allocations"),
+		tr("Per Frame (ms)"), tr("Max Frame (ms)")
+	});
+	m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+	m_table->verticalHeader()->hide();
+	m_table->horizontalHeader()->setSectionResizeMode(COLUMN_NAME, QHeaderView::Stretch);
+	m_table->setSortingEnabled(true);
+	m_table->sortByColumn(COLUMN_FRAME_TIME, Qt::DescendingOrder);
+	layout->addWidget(m_table);
+
+	m_refreshTimer.setInterval(REFRESH_INTERVAL);
+
+	connect(m_profileButton, &QToolButton::toggled, this, &BehaviorProfilerWidget::setProfiling);
+	connect(m_grouping, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &BehaviorProfilerWidget::refresh);
+	connect(resetButton, &QToolButton::clicked, this, &BehaviorProfilerWidget::reset);
+	connect(exportButton, &QToolButton::clicked, this, &BehaviorProfilerWidget::exportCsv);
+	connect(&m_refreshTimer, &QTimer::timeout, this, &BehaviorProfilerWidget::refresh);
+
+	refresh();
+}
+
+void BehaviorProfilerWidget::setProfiler(BehaviorProfiler* profiler)
+{
+	m_profiler = profiler;
+	setProfiling(m_profileButton->isChecked());
+}
+
+void BehaviorProfilerWidget::setProfiling(bool profiling)
+{
+	if(m_profiler)
+		m_profiler->setEnabled(profiling);
+
+	if(profiling)
+		m_refreshTimer.start();
+	else
+		m_refreshTimer.stop();
+
+	refresh();
+}
+
+void BehaviorProfilerWidget::refresh()
+{
+	if(!m_profiler)
+	{
+		m_table->setRowCount(0);
+		m_frames->clear();
+		return;
+	}
+
+	// Hidden docks do not need to keep up, the next tick after showing them catches up
+	if(!isVisible() && m_refreshTimer.isActive())
+		return;
+
+	const double frames = std::max<uint64_t>(m_profiler->getFrames(), 1);
+	m_frames->setText(tr("%n frame(s)", nullptr, static_cast<int>(m_profiler->getFrames())));
+
+	// Rows would be moved while they are filled otherwise
+	m_table->setSortingEnabled(false);
+
+	int row = 0;
+	if(m_grouping->currentIndex() == 0)
+	{
+		m_table->setRowCount(m_profiler->getBehaviors().size());
+		for(auto& e : m_profiler->getBehaviors())
+			addRow(row++, QString::fromStdString(e.second.name), e.second, frames);
+	}
+	else
+	{
+		m_table->setRowCount(m_profiler->getObjects().size());
+		for(auto& e : m_profiler->getObjects())
+		{
+			// Unnamed objects are only told apart by their index
+			auto name = QString::fromStdString(e.second.name);
+			if(name.isEmpty())
+				name = "#" + QString::number(e.first);
+
+			addRow(row++, name, e.second, frames);
+		}
+	}
+
+	m_table->setSortingEnabled(true);
+}
+
+void BehaviorProfilerWidget::addRow(int row, const QString& name, const BehaviorProfiler::Entry& entry, double frames)
+{
+	m_table->setItem(row, COLUMN_NAME, new QTableWidgetItem(name));
+	m_table->setItem(row, COLUMN_TIME, numberItem(entry.time));
+	m_table->setItem(row, COLUMN_CALLS, numberItem(entry.calls));
+	m_table->setItem(row, COLUMN_ALLOCATIONS, numberItem(entry.allocations));
+	m_table->setItem(row, COLUMN_FRAME_TIME, numberItem(entry.time / frames));
+	m_table->setItem(row, COLUMN_MAX_FRAME_TIME, numberItem(entry.maxFrameTime));
+}
+
+void BehaviorProfilerWidget::reset()
+{
+	if(m_profiler)
+		m_profiler->clear();
+
+	refresh();
+}
+
+void BehaviorProfilerWidget::exportCsv()
+{
+	if(!m_profiler)
+		return;
+
+	const auto file = QFileDialog::getSaveFileName(this, tr("Export Behavior Profile"), ".", tr("CSV (*.csv)"));
+	if(file.isEmpty())
+		return;
+
+	QFile out(file);
+	const auto data = m_profiler->toCsv().toUtf8();
+	if(!out.open(QFile::WriteOnly | QFile::Truncate) || out.write(data) != data.size())
+		QMessageBox::critical(this, tr("Error"), tr("Could not export behavior profile!"));
+}
@@ -0,0 +1,60 @@
+#ifndef NEO_BEHAVIORPROFILERWIDGET_H
+#define NEO_BEHAVIORPROFILERWIDGET_H
+
+#include <QComboBox>
+#include <QLabel>
+#include <QTableWidget>
+#include <QTimer>
+#include <QToolButton>
+#include <QWidget>
+
+#include <profiling/BehaviorProfiler.h>
+
+namespace Neo 
+{
+
+/**
+ * Live table of a BehaviorProfiler, sortable by every column and grouped
+ * either by behavior type or by object. The table is refreshed periodically
+ * while profiling and can be exported as CSV.
+ */
+class BehaviorProfilerWidget : public QWidget
+{
+	Q_OBJECT;
+public:
+	BehaviorProfilerWidget(QWidget* parent);
+
+	void setProfiler(BehaviorProfiler* profiler);
+
+public slots:
+	void setProfiling(bool profiling);
+	void refresh();
+	void reset();
+	void exportCsv();
+
+private:
+	enum COLUMN
+	{
+		COLUMN_NAME = 0,
+		COLUMN_TIME,
+		COLUMN_CALLS,
+		COLUMN_ALLOCATIONS,
+		COLUMN_FRAME_TIME,
+		COLUMN_MAX_FRAME_TIME,
+		COLUMN_COUNT
+	};
+
+	void addRow(int row, const QString& name, const BehaviorProfiler::Entry& entry, double frames);
+
+	BehaviorProfiler* m_profiler = nullptr;
+
+	QToolButton* m_profileButton;
+	QComboBox* m_grouping;
+	QLabel* m_frames;
+	QTableWidget* m_table;
+	QTimer m_refreshTimer;
+};
+
+}
+
+#endif
@@ -0,0 +1,553 @@
+#include "LevelTreeModel.h"
+#include <Log.h>
+
+#include <QMimeData>
+
+#include <iterator>
+
+using namespace Neo;
+
+static const char* s_objectMimeType = "application/x-neo-objects";
+
+// Above this many row ranges in one parent, resetting the model is cheaper than signaling each
+static const size_t s_maxRanges = 32;
+
+LevelTreeModel::LevelTreeModel(QObject* parent):
+	QAbstractItemModel(parent)
+{
+
+}
+
+void LevelTreeModel::setLevel(std::shared_ptr<Level> level, LevelJournal* journal)
+{
+	m_level = level;
+	m_journal = journal;
+	m_cursor = (journal ? journal->head() : 0);
+	rebuild();
+}
+
+void LevelTreeModel::rebuild()
+{
+	beginResetModel();
+
+	m_dirty.clear();
+	m_removed.clear();
+	m_nodes.clear();
+	m_root.children.clear();
+	m_root.fetched = false;
+	m_root.object = (m_level ? m_level->getRoot() : ObjectHandle());
+
+	if(!m_root.object.empty())
+	{
+		m_nodes[m_root.object] = &m_root;
+		populate(&m_root);
+	}
+
+	endResetModel();
+}
+
+void LevelTreeModel::sync()
+{
+	if(!m_journal || !m_level)
+		return;
+
+	const bool complete = m_journal->read(m_cursor, [this](const LevelJournal::Event& e) {
+		switch(e.type)
+		{
+		case LevelJournal::OBJECT_ADDED:
+		case LevelJournal::OBJECT_REPARENTED:
+			objectAdded(e.object, e.parent);
+			break;
+
+		case LevelJournal::OBJECT_REMOVED:
+			objectRemoved(e.object);
+			break;
+
+		case LevelJournal::OBJECT_RENAMED:
+		{
+			auto idx = indexOf(find(e.object));
+			if(idx.isValid())
+				emit dataChanged(idx, idx, {Qt::DisplayRole});
+		}
+		break;
+
+		default: break;
+		}
+	});
+
+	if(!complete)
+		rebuild();
+	else
+		flush();
+}
+
+ObjectHandle LevelTreeModel::getObject(const QModelIndex& index) const
+{
+	if(!index.isValid())
+		return ObjectHandle();
+
+	return nodeFor(index)->object;
+}
+
+QModelIndex LevelTreeModel::indexOf(ObjectHandle object)
+{
+	if(object.empty() || !m_level)
+		return QModelIndex();
+
+	if(auto* node = find(object))
+		return indexOf(node);
+
+	// Collect the ancestors up to the first one which has a row already
+	std::vector<ObjectHandle> path;
+	for(auto p = object->getParent(); !p.empty(); p = p->getParent())
+	{
+		path.push_back(p);
+		if(find(p))
+			break;
+	}
+
+	// Then create the missing rows from the top down
+	for(auto iter = path.rbegin(); iter != path.rend(); iter++)
+	{
+		auto* node = find(*iter);
+		if(!node)
+			return QModelIndex();
+
+		fetch(node);
+	}
+
+	return indexOf(find(object));
+}
+
+QModelIndex LevelTreeModel::index(int row, int column, const QModelIndex& parent) const
+{
+	if(!hasIndex(row, column, parent))
+		return QModelIndex();
+
+	return createIndex(row, column, nodeFor(parent)->children[row].get());
+}
+
+QModelIndex LevelTreeModel::parent(const QModelIndex& index) const
+{
+	if(!index.isValid())
+		return QModelIndex();
+
+	return indexOf(nodeFor(index)->parent);
+}
+
+int LevelTreeModel::rowCount(const QModelIndex& parent) const
+{
+	if(parent.column() > 0)
+		return 0;
+
+	return nodeFor(parent)->children.size();
+}
+
+int LevelTreeModel::columnCount(const QModelIndex& parent) const
+{
+	return 1;
+}
+
+bool LevelTreeModel::hasChildren(const QModelIndex& parent) const
+{
+	auto* node = nodeFor(parent);
+	if(node->fetched)
+		return !node->children.empty();
+
+	return !node->object.empty() && !node->object->getChildren().empty();
+}
+
+QVariant LevelTreeModel::data(const QModelIndex& index, int role) const
+{
+	if(!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole))
+		return QVariant();
+
+	return QString(nodeFor(index)->object->getName().str());
+}
+
+Qt::ItemFlags LevelTreeModel::flags(const QModelIndex& index) const
+{
+	if(!index.isValid())
+		return Qt::ItemIsDropEnabled;
+
+	return QAbstractItemModel::flags(index) | Qt::ItemIsDragEnabled | Qt::ItemIsDropEnabled;
+}
+
+bool LevelTreeModel::canFetchMore(const QModelIndex& parent) const
+{
+	auto* node = nodeFor(parent);
+	return !node->fetched && !node->object.empty() && !node->object->getChildren().empty();
+}
+
+void LevelTreeModel::fetchMore(const QModelIndex& parent)
+{
+	fetch(nodeFor(parent));
+}
+
+Qt::DropActions LevelTreeModel::supportedDropActions() const
+{
+	return Qt::MoveAction;
+}
+
+QStringList LevelTreeModel::mimeTypes() const
+{
+	return QStringList(s_objectMimeType);
+}
+
+QMimeData* LevelTreeModel::mimeData(const QModelIndexList& indexes) const
+{
+	m_dragged.clear();
+	for(auto& index : indexes)
+	{
+		if(index.isValid() && index.column() == 0)
+			m_dragged.push_back(nodeFor(index)->object);
+	}
+
+	auto* data = new QMimeData;
+	data->setData(s_objectMimeType, QByteArray());
+	return data;
+}
+
+bool LevelTreeModel::dropMimeData(const QMimeData* data, Qt::DropAction action, int row, int column, const QModelIndex& parent)
+{
+	if(action == Qt::IgnoreAction)
+		return true;
+
+	if(!data->hasFormat(s_objectMimeType) || !m_level)
+		return false;
+
+	// Dropping between rows still drops into the parent, the order is given by the level
+	auto target = (parent.isValid() ? nodeFor(parent)->object : m_level->getRoot());
+
+	LOG_DEBUG("Dropping " << m_dragged.size() << " objects");
+	for(auto& object : m_dragged)
+	{
+		// Objects can not become children of themselves
+		bool cycle = false;
+		for(auto p = target; !p.empty() && !cycle; p = p->getParent())
+			cycle = (p == object);
+
+		if(cycle || object->getParent() == target)
+			continue;
+
+		object->setParent(target);
+		object->updateMatrix();
+
+		if(m_journal)
+			m_journal->record(LevelJournal::OBJECT_REPARENTED, object, target);
+	}
+
+	m_dragged.clear();
+
+	sync();
+	emit objectsReparented();
+	return true;
+}
+
+LevelTreeModel::Node* LevelTreeModel::nodeFor(const QModelIndex& index) const
+{
+	if(!index.isValid())
+		return const_cast<Node*>(&m_root);
+
+	return static_cast<Node*>(index.internalPointer());
+}
+
+LevelTreeModel::Node* LevelTreeModel::find(ObjectHandle object) const
+{
+	auto iter = m_nodes.find(object);
+	return (iter == m_nodes.end() ? nullptr : iter->second);
+}
+
+QModelIndex LevelTreeModel::indexOf(Node* node) const
+{
+	if(!node || node == &m_root)
+		return QModelIndex();
+
+	return createIndex(node->row, 0, node);
+}
+
+void LevelTreeModel::populate(Node* node)
+{
+	for(auto& child : node->object->getChildren())
+	{
+		auto n = std::make_unique<Node>();
+		n->object = child;
+		n->parent = node;
+		n->row = node->children.size();
+
+		m_nodes[child] = n.get();
+		node->children.push_back(std::move(n));
+	}
+
+	node->fetched = true;
+}
+
+void LevelTreeModel::fetch(Node* node)
+{
+	if(node->fetched)
+		return;
+
+	// Rows which were shown somewhere else and are not up to date
+	for(auto& child : node->object->getChildren())
+	{
+		if(auto* stale = find(child))
+			removeNode(stale);
+	}
+
+	const int count = node->object->getChildren().size();
+	if(count == 0)
+	{
+		node->fetched = true;
+		return;
+	}
+
+	beginInsertRows(indexOf(node), 0, count - 1);
+	populate(node);
+	endInsertRows();
+}
+
+int LevelTreeModel::rowFor(Node* parent, ObjectHandle object) const
+{
+	// Siblings which are not in the model yet get their rows from later events
+	int row = 0;
+	for(auto& child : parent->object->getChildren())
+	{
+		if(child == object)
+			break;
+
+		auto* node = find(child);
+		if(node && node->parent == parent)
+			row++;
+	}
+
+	return row;
+}
+
+void LevelTreeModel::insertNode(Node* parent, ObjectHandle object)
+{
+	// Only for moves which can not be signaled as such, added objects are batched by reconcile()
+	const int row = rowFor(parent, object);
+	beginInsertRows(indexOf(parent), row, row);
+
+	auto n = std::make_unique<Node>();
+	n->object = object;
+	n->parent = parent;
+	n->row = row;
+
+	m_nodes[object] = n.get();
+	parent->children.insert(parent->children.begin() + row, std::move(n));
+	for(size_t i = row + 1; i < parent->children.size(); i++)
+		parent->children[i]->row = i;
+
+	endInsertRows();
+}
+
+void LevelTreeModel::removeNode(Node* node)
+{
+	auto* parent = node->parent;
+	const int row = node->row;
+
+	beginRemoveRows(indexOf(parent), row, row);
+
+	forget(node);
+	parent->children.erase(parent->children.begin() + row);
+	for(size_t i = row; i < parent->children.size(); i++)
+		parent->children[i]->row = i;
+
+	endRemoveRows();
+}
+
+void LevelTreeModel::moveNode(Node* node, Node* newParent)
+{
+	auto* parent = node->parent;
+	const int row = node->row;
+	const int destination = rowFor(newParent, node->object);
+
+	if(!beginMoveRows(indexOf(parent), row, row, indexOf(newParent), destination))
+	{
+		auto object = node->object;
+		removeNode(node);
+		insertNode(newParent, object);
+		return;
+	}
+
+	auto n = std::move(parent->children[row]);
+	parent->children.erase(parent->children.begin() + row);
+	for(size_t i = row; i < parent->children.size(); i++)
+		parent->children[i]->row = i;
+
+	n->parent = newParent;
+	newParent->children.insert(newParent->children.begin() + destination, std::move(n));
+	for(size_t i = destination; i < newParent->children.size(); i++)
+		newParent->children[i]->row = i;
+
+	endMoveRows();
+}
+
+void LevelTreeModel::forget(Node* node)
+{
+	m_nodes.erase(node->object);
+	for(auto& child : node->children)
+		forget(child.get());
+}
+
+void LevelTreeModel::flush()
+{
+	auto dirty = std::move(m_dirty);
+	m_dirty.clear();
+
+	for(auto& object : dirty)
+	{
+		// Parents can be gone already with the removal of one of their ancestors
+		auto* node = find(object);
+		if(node && !reconcile(node))
+		{
+			LOG_DEBUG("Too many changes in " << object->getName() << ", resetting the level tree");
+			rebuild();
+			return;
+		}
+	}
+
+	m_removed.clear();
+}
+
+bool LevelTreeModel::reconcile(Node* parent)
+{
+	// Removed objects can be back already, e.g. when a delete was undone before the sync
+	auto& objects = parent->object->getChildren();
+	std::unordered_set<ObjectHandle, ObjectHandleHash> present(objects.begin(), objects.end());
+
+	std::vector<std::pair<int, int>> removed;
+	for(auto& child : parent->children)
+	{
+		if(!m_removed.count(child->object) || present.count(child->object))
+			continue;
+
+		if(!removed.empty() && removed.back().second + 1 == child->row)
+			removed.back().second = child->row;
+		else
+			removed.emplace_back(child->row, child->row);
+	}
+
+	// The rows of added objects in one pass, following their position in the level.
+	// Rows are the final ones, after the removals and the preceding insertions.
+	std::vector<std::pair<int, std::vector<ObjectHandle>>> added;
+	int row = 0;
+	bool adjacent = false;
+	for(auto& object : objects)
+	{
+		auto* node = find(object);
+		if(node)
+		{
+			// Rows which are elsewhere now are moved by their own event
+			if(node->parent == parent)
+				row++;
+
+			adjacent = false;
+			continue;
+		}
+
+		if(!adjacent)
+			added.emplace_back(row, std::vector<ObjectHandle>());
+
+		added.back().second.push_back(object);
+		adjacent = true;
+		row++;
+	}
+
+	if(removed.size() + added.size() > s_maxRanges)
+		return false;
+
+	// From the back, so the rows of the remaining ranges stay valid
+	const auto index = indexOf(parent);
+	auto& children = parent->children;
+	for(auto r = removed.rbegin(); r != removed.rend(); r++)
+	{
+		beginRemoveRows(index, r->first, r->second);
+
+		for(int i = r->first; i <= r->second; i++)
+			forget(children[i].get());
+
+		children.erase(children.begin() + r->first, children.begin() + r->second + 1);
+		for(size_t i = r->first; i < children.size(); i++)
+			children[i]->row = i;
+
+		endRemoveRows();
+	}
+
+	// From the front, so each range lands on its final rows
+	for(auto& range : added)
+	{
+		const int first = range.first;
+		beginInsertRows(index, first, first + range.second.size() - 1);
+
+		std::vector<std::unique_ptr<Node>> nodes;
+		nodes.reserve(range.second.size());
+		for(auto& object : range.second)
+		{
+			auto n = std::make_unique<Node>();
+			n->object = object;
+			n->parent = parent;
+
+			m_nodes[object] = n.get();
+			nodes.push_back(std::move(n));
+		}
+
+		children.insert(children.begin() + first, std::make_move_iterator(nodes.begin()), std::make_move_iterator(nodes.end()));
+		for(size_t i = first; i < children.size(); i++)
+			children[i]->row = i;
+
+		endInsertRows();
+	}
+
+	return true;
+}
+
+void LevelTreeModel::objectAdded(ObjectHandle object, ObjectHandle parent)
+{
+	auto* parentNode = find(parent);
+	auto* node = find(object);
+
+	// Branches which are not expanded yet pick up the object when they are fetched
+	const bool visible = parentNode && parentNode->fetched;
+
+	if(node)
+	{
+		if(node == &m_root || node->parent == parentNode)
+			return;
+
+		// Moving into its own subtree would be a cycle, the journal will catch up later
+		bool cycle = false;
+		for(auto* p = parentNode; p && !cycle; p = p->parent)
+			cycle = (p == node);
+
+		if(visible && !cycle)
+		{
+			moveNode(node, parentNode);
+			return;
+		}
+
+		removeNode(node);
+	}
+	else if(visible)
+	{
+		// E.g. undoing a delete puts the objects back at their old positions in one batch
+		m_dirty.insert(parent);
+		return;
+	}
+
+	// The parent might show an expand arrow now
+	auto idx = indexOf(parentNode);
+	if(idx.isValid())
+		emit dataChanged(idx, idx);
+}
+
+void LevelTreeModel::objectRemoved(ObjectHandle object)
+{
+	auto* node = find(object);
+	if(node && node != &m_root)
+	{
+		m_removed.insert(object);
+		m_dirty.insert(node->parent->object);
+	}
+}
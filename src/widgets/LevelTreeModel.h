@@ -0,0 +1,113 @@
+#ifndef NEO_LEVELTREEMODEL_H
+#define NEO_LEVELTREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <Level.h>
+#include <LevelJournal.h>
+#include <ObjectHandleHash.h>
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Neo
+{
+
+/**
+ * Item model backed directly by the object hierarchy of a level.
+ *
+ * Rows are only created when a branch is expanded (fetchMore), so big levels
+ * do not cost anything until they are looked at. Changes are applied from the
+ * LevelJournal with fine grained row moves, insertions and removals are
+ * batched per parent and signaled as contiguous ranges.
+ */
+class LevelTreeModel : public QAbstractItemModel
+{
+	Q_OBJECT;
+
+	struct Node
+	{
+		ObjectHandle object;
+		Node* parent = nullptr;
+		std::vector<std::unique_ptr<Node>> children;
+		int row = 0; // Row in the parent
+		bool fetched = false; // If the children were created already
+	};
+
+public:
+	LevelTreeModel(QObject* parent);
+
+	void setLevel(std::shared_ptr<Level> level, LevelJournal* journal);
+
+	/// Applies all journal events since the last sync
+	void sync();
+
+	ObjectHandle getObject(const QModelIndex& index) const;
+
+	/// Returns the index of the object, fetches all of its ancestors if required
+	QModelIndex indexOf(ObjectHandle object);
+
+	QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+	QModelIndex parent(const QModelIndex& index) const override;
+	int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+	int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+	bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+	bool canFetchMore(const QModelIndex& parent) const override;
+	void fetchMore(const QModelIndex& parent) override;
+
+	Qt::DropActions supportedDropActions() const override;
+	QStringList mimeTypes() const override;
+	QMimeData* mimeData(const QModelIndexList& indexes) const override;
+	bool dropMimeData(const QMimeData* data, Qt::DropAction action, int row, int column, const QModelIndex& parent) override;
+
+signals:
+	/// Emitted after objects were reparented by drag and drop
+	void objectsReparented();
+
+private:
+	void rebuild();
+
+	Node* nodeFor(const QModelIndex& index) const;
+	Node* find(ObjectHandle object) const;
+	QModelIndex indexOf(Node* node) const;
+
+	void populate(Node* node);
+	void fetch(Node* node);
+	/// The row the object gets in the parent, following its position in the level
+	int rowFor(Node* parent, ObjectHandle object) const;
+
+	void insertNode(Node* parent, ObjectHandle object);
+	void removeNode(Node* node);
+	void moveNode(Node* node, Node* newParent);
+	void forget(Node* node);
+
+	/// Applies the batched changes of every dirty parent, resets the model if one has too many ranges
+	void flush();
+	/// Inserts and removes the rows of the parent in contiguous ranges, returns false if there are too many
+	bool reconcile(Node* parent);
+
+	void objectAdded(ObjectHandle object, ObjectHandle parent);
+	void objectRemoved(ObjectHandle object);
+
+	std::shared_ptr<Level> m_level;
+	LevelJournal* m_journal = nullptr;
+	uint64_t m_cursor = 0;
+
+	Node m_root;
+	std::unordered_map<ObjectHandle, Node*, ObjectHandleHash> m_nodes;
+
+	// Changes of the current sync, applied per parent by flush()
+	std::unordered_set<ObjectHandle, ObjectHandleHash> m_dirty;
+	std::unordered_set<ObjectHandle, ObjectHandleHash> m_removed;
+
+	// Objects which are currently dragged, drops only happen within the same view
+	mutable std::vector<ObjectHandle> m_dragged;
+};
+
+}
+
+#endif
@@ -1,46 +1,28 @@
 #include "LevelTreeWidget.h"
+#include "LevelTreeModel.h"
 #include <Log.h>
+#include <profiling/Trace.h>
 
-#include <QTreeWidgetItem>
 #include <QAction>
 #include <QMenu>
-#include <QDropEvent>
 
 using namespace Neo;
 
-class ObjectItem : public QTreeWidgetItem
-{
-	ObjectHandle m_object;
-public:
-	ObjectItem(QTreeWidgetItem* parent, const QStringList& strings, ObjectHandle object):
-		QTreeWidgetItem(parent, strings),
-		m_object(object) {}
-
-	ObjectHandle getObject() const { return m_object; }
-};
-
 LevelTreeWidget::LevelTreeWidget(QWidget* parent):
-	QTreeWidget(parent)
+	QTreeView(parent),
+	m_model(new LevelTreeModel(this))
 {
-	setColumnCount(1);
+	setModel(m_model);
 	setHeaderHidden(true);
+	setUniformRowHeights(true);
 	setSelectionBehavior(SelectionBehavior::SelectRows);
 	setSelectionMode(SelectionMode::ExtendedSelection);
 
 	setContextMenuPolicy(Qt::CustomContextMenu);
 	
-	connect(this, &QTreeWidget::itemSelectionChanged, this, &LevelTreeWidget::selectionChangedSlot);
-	connect(this, &QTreeWidget::customContextMenuRequested, this, &LevelTreeWidget::contextMenuSlot);
-}
-
-void LevelTreeWidget::addObject(ObjectHandle object, QTreeWidgetItem* parent, bool onlyChildren)
-{
-	QTreeWidgetItem* item = (onlyChildren ? parent : new ObjectItem(parent, QStringList(object->getName().str()), object));
-
-	for(auto& child : object->getChildren())
-	{
-		addObject(child, item, false);
-	}
+	connect(selectionModel(), &QItemSelectionModel::selectionChanged, this, &LevelTreeWidget::selectionChangedSlot);
+	connect(this, &QTreeView::customContextMenuRequested, this, &LevelTreeWidget::contextMenuSlot);
+	connect(m_model, &LevelTreeModel::objectsReparented, this, &LevelTreeWidget::levelChanged);
 }
 
 void LevelTreeWidget::levelChangedSlot()
@@ -48,80 +30,99 @@ void LevelTreeWidget::levelChangedSlot()
 	if(m_level == nullptr)
 		return;
 	
-	clear();
-	addObject(m_level->getRoot(), invisibleRootItem(), true);
+	TRACE_SCOPE("Level tree sync");
+	m_model->sync();
 }
 
 void LevelTreeWidget::setLevel(std::shared_ptr<Level> h)
 {
 	m_level = h;
-	levelChangedSlot();
+	m_model->setLevel(m_level, m_journal);
 }
 
-void LevelTreeWidget::selectionChangedSlot()
+void LevelTreeWidget::setJournal(LevelJournal* journal)
 {
-	if(selectedItems().empty())
-		return;
-	
-	auto item = dynamic_cast<ObjectItem*>(this->selectedItems()[0]);
-	if(!item)
+	m_journal = journal;
+	m_model->setLevel(m_level, m_journal);
+}
+
+void LevelTreeWidget::setObjectSelection(ObjectSelection* selection)
+{
+	if(m_objectSelection)
+		disconnect(m_objectSelection, nullptr, this, nullptr);
+
+	m_objectSelection = selection;
+	if(m_objectSelection)
+		connect(m_objectSelection, &ObjectSelection::changed, this, &LevelTreeWidget::objectSelectionChangedSlot);
+}
+
+void LevelTreeWidget::selectionChangedSlot(const QItemSelection& selected, const QItemSelection& deselected)
+{
+	if(m_updatingSelection || !m_objectSelection)
 		return;
-	
-	emit objectSelectionChanged(item->getObject());
-	
-	m_selection.clear();
-	m_selection.reserve(selectedItems().size());
-	for(size_t i = 0; i < selectedItems().size(); i++)
+
+	// Only apply the difference, the view already shows the new selection
+	std::vector<ObjectHandle> added, removed;
+	for(auto& index : deselected.indexes())
 	{
-		auto item = dynamic_cast<ObjectItem*>(selectedItems()[i]);
-		if(item)
-			m_selection.push_back(item->getObject());
+		if(index.column() == 0)
+			removed.push_back(m_model->getObject(index));
 	}
-	
-	emit objectSelectionListChanged(m_selection);
+
+	for(auto& index : selected.indexes())
+	{
+		if(index.column() == 0)
+			added.push_back(m_model->getObject(index));
+	}
+
+	const bool changed = m_objectSelection->remove(removed) | m_objectSelection->add(added);
+	m_ownSelectionChange = m_ownSelectionChange || changed;
 }
 
-void LevelTreeWidget::setSelectionList(const std::vector<ObjectHandle>& objects)
+void LevelTreeWidget::objectSelectionChangedSlot()
 {
-	if(objects.empty())
+	auto& objects = m_objectSelection->getObjects();
+	if(!m_ownSelectionChange)
 	{
-		blockSignals(true);
-		clearSelection();
-		m_selection.clear();
-		blockSignals(false);
-
-		emit objectSelectionChanged(ObjectHandle());
+		setSelectionList(objects);
 		return;
 	}
-	
-	blockSignals(true);
-	m_selection = objects;
-	
-	clearSelection();
-	
-	for(size_t i = 0; i < topLevelItemCount(); i++)
+
+	m_ownSelectionChange = false;
+	emit objectSelectionChanged(objects.empty() ? ObjectHandle() : objects[0]);
+}
+
+void LevelTreeWidget::setSelectionList(const std::vector<ObjectHandle>& objects)
+{
+	m_updatingSelection = true;
+
+	// Select everything at once instead of row by row
+	QItemSelection selection;
+	QModelIndex first;
+	for(auto& object : objects)
 	{
-		auto item = dynamic_cast<ObjectItem*>(topLevelItem(i));
-		if(item && std::find(objects.begin(), objects.end(), item->getObject()) != objects.end())
-		{
-			item->setSelected(true);
-			scrollToItem(item);
-		}
+		auto index = m_model->indexOf(object);
+		if(!index.isValid())
+			continue;
+
+		if(!first.isValid())
+			first = index;
+
+		selection.select(index, index);
 	}
+
+	selectionModel()->select(selection, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+	if(first.isValid())
+		scrollTo(first);
+
+	m_updatingSelection = false;
 	
-	blockSignals(false);
-	
-	emit objectSelectionChanged(objects[0]);
+	emit objectSelectionChanged(objects.empty() ? ObjectHandle() : objects[0]);
 }
 
 void LevelTreeWidget::contextMenuSlot(const QPoint& pos)
 {
-	QTreeWidgetItem* nd = itemAt(pos);
-	if(!nd)
-		return;
-
-	const std::string label = nd->text(0).toStdString();
-	auto obj = m_level->find(label.c_str());
+	auto obj = m_model->getObject(indexAt(pos));
 	if(obj.empty())
 		return;
 
@@ -133,51 +134,12 @@ void LevelTreeWidget::contextMenuSlot(const QPoint& pos)
 		QAction* newAct = new QAction(tr("Set as Main Camera"), this);
 		newAct->setStatusTip(tr("Set this camera as the default camera for the level."));
 	
-		connect(newAct, &QAction::triggered, [this, label]() {
-			m_level->setMainCameraName(label.c_str());
+		connect(newAct, &QAction::triggered, [this, obj]() {
+			m_level->setMainCameraName(obj->getName().str());
 		});
 		
 		menu.addAction(newAct);
 	}
 
-	QPoint pt(pos);
-	menu.exec(mapToGlobal(pos));
-}
-
-void LevelTreeWidget::dropEvent(QDropEvent* event)
-{
-	auto items = QTreeWidget::selectedItems();
-
-	// First, execute drop
-	QTreeWidget::dropEvent(event);
-
-	// Update scene to reflect new parent-child relationships
-	LOG_DEBUG("Dropping items");
-	for(auto* item : items)
-	{
-		LOG_DEBUG("Dropping: " << item->text(0).toStdString());
-		auto object = static_cast<ObjectItem*>(item)->getObject();
-		
-		auto* newParentItem = item->parent();
-		if(newParentItem == nullptr)
-		{
-			object->setParent(m_level->getRoot());
-			object->updateMatrix();
-			continue;
-		}
-
-		auto parentObject = m_level->find(newParentItem->text(0).toUtf8().data());
-		if(parentObject.empty())
-			LOG_WARNING("Parent not found!");
-
-		object->setParent(parentObject);
-		object->updateMatrix();
-	}
-	
-	//LOG_INFO(QTreeWidget:)
-	//auto* source = dynamic_cast<ObjectItem*>(event->source());
-	//if(!source)
-	//	return;
-
-	//LOG_DEBUG("Dropped " << source->getObject()->getName());
+	menu.exec(viewport()->mapToGlobal(pos));
 }
@@ -1,13 +1,17 @@
 #ifndef NEO_LEVELTREEWIDGET_H
 #define NEO_LEVELTREEWIDGET_H
 
-#include <QTreeWidget>
+#include <QTreeView>
 #include <Level.h>
+#include <LevelJournal.h>
+#include <ObjectSelection.h>
 
 namespace Neo 
 {
 
-class LevelTreeWidget : public QTreeWidget
+class LevelTreeModel;
+
+class LevelTreeWidget : public QTreeView
 {
 	Q_OBJECT;
 	std::shared_ptr<Level> m_level;
@@ -16,10 +20,16 @@ public:
 	
 	void setLevel(std::shared_ptr<Level> h);
 	std::shared_ptr<Level> getLevel() const { return m_level; }
+
+	void setJournal(LevelJournal* journal);
+
+	/// The selection shared with the viewport, the tree follows and modifies it
+	void setObjectSelection(ObjectSelection* selection);
 	
 public slots:
 	void levelChangedSlot();
-	void selectionChangedSlot();
+	void selectionChangedSlot(const QItemSelection& selected, const QItemSelection& deselected);
+	void objectSelectionChangedSlot();
 	
 	void setSelectionList(const std::vector<ObjectHandle>& objects);
 	void contextMenuSlot(const QPoint& pos);
@@ -27,15 +37,15 @@ public slots:
 signals:
 	void levelChanged();
 	void objectSelectionChanged(ObjectHandle);
-	void objectSelectionListChanged(const std::vector<ObjectHandle>&);
-
-protected:
-	void dropEvent(QDropEvent* event) override;
 
 private:
-	void addObject(ObjectHandle object, QTreeWidgetItem* parent, bool onlyChildren = false);
-	
-	std::vector<ObjectHandle> m_selection;
+	LevelTreeModel* m_model;
+	LevelJournal* m_journal = nullptr;
+	ObjectSelection* m_objectSelection = nullptr;
+
+	bool m_updatingSelection = false; // The view is being synced to the selection
+	bool m_ownSelectionChange = false; // The selection was changed by the view
+
 };
 
 }
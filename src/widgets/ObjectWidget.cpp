@@ -27,10 +27,47 @@ ObjectWidget::ObjectWidget(QWidget* parent):
 	setColumnCount(2);
 	setHeaderHidden(false);
 	setHeaderLabels(QStringList() << tr("Property") << tr("Value"));
+
+	// An edit burst ends when the value did not change for a while
+	m_editTimer.setSingleShot(true);
+	m_editTimer.setInterval(500);
+	connect(&m_editTimer, &QTimer::timeout, this, &ObjectWidget::finishEdit);
+}
+
+void ObjectWidget::beginEdit(const QString& property)
+{
+	// Values are being set programmatically
+	if(signalsBlocked())
+		return;
+
+	if(!m_editProperty.isEmpty() && m_editProperty != property)
+		finishEdit();
+
+	if(m_editProperty.isEmpty())
+	{
+		m_editProperty = property;
+		emit beginUndoableChange(m_object, property);
+	}
+
+	m_editTimer.start();
+	emit objectChanged(m_object);
+}
+
+void ObjectWidget::finishEdit()
+{
+	m_editTimer.stop();
+	if(m_editProperty.isEmpty())
+		return;
+
+	const QString property = m_editProperty;
+	m_editProperty.clear();
+	emit endUndoableChange(m_object, property);
 }
 
 void ObjectWidget::setObject(ObjectHandle h)
 {
+	finishEdit();
+
 	m_object = h;
 	clear();
 
@@ -81,35 +118,33 @@ QTreeWidgetItem* ObjectWidget::createTransform(ObjectHandle o)
 
 	connect(m_position, &VectorWidgetBase::valueChanged, [o, this]() mutable {
 
-		emit beginUndoableChange();
+		beginEdit("Transform/Position");
 
 		o->setPosition(m_position->value());
 		o->updateMatrix();
-
-		emit endUndoableChange();
 	});
 	
 	connect(m_rotation, &VectorWidgetBase::valueChanged, [o, this]() mutable {
 
-		emit beginUndoableChange();
+		beginEdit("Transform/Rotation");
 
 		Quaternion rot;
 		rot.setFromAngles(m_rotation->value());
 		o->setRotation(rot);
 		o->updateMatrix();
-
-		emit endUndoableChange();
 	});
 	
 	connect(m_scale, &VectorWidgetBase::valueChanged, [o, this]() mutable {
 		
-		emit beginUndoableChange();
+		beginEdit("Transform/Scale");
 
 		o->setScale(m_scale->value());
 		o->updateMatrix();
-
-		emit endUndoableChange();
 	});
+
+	connect(m_position, &VectorWidgetBase::editingFinished, this, &ObjectWidget::finishEdit);
+	connect(m_rotation, &VectorWidgetBase::editingFinished, this, &ObjectWidget::finishEdit);
+	connect(m_scale, &VectorWidgetBase::editingFinished, this, &ObjectWidget::finishEdit);
 	
 	return title;
 }
@@ -120,6 +155,7 @@ QTreeWidgetItem* ObjectWidget::createBehavior(Behavior* b)
 	for(auto prop : b->getProperties())
 	{
 		auto propItem = new QTreeWidgetItem(title, QStringList() << prop->getName().c_str());
+		const QString propertyKey = QString(b->getName()) + "/" + prop->getName().c_str();
 		switch(prop->getType())
 		{
 		case BOOL:
@@ -127,13 +163,13 @@ QTreeWidgetItem* ObjectWidget::createBehavior(Behavior* b)
 			QCheckBox* widget;
 			setItemWidget(propItem, 1, widget = new QCheckBox(this));
 			
-			connect(widget, QOverload<int>::of(&QCheckBox::stateChanged), [prop, b, this](int value) mutable {
-				emit beginUndoableChange();
+			connect(widget, QOverload<int>::of(&QCheckBox::stateChanged), [prop, b, propertyKey, this](int value) mutable {
+				beginEdit(propertyKey);
 		
 				prop->set(value == Qt::CheckState::Checked);
 				b->propertyChanged(prop, *m_level);
 				
-				emit endUndoableChange();
+				finishEdit();
 			});
 		}
 		break;
@@ -146,14 +182,14 @@ QTreeWidgetItem* ObjectWidget::createBehavior(Behavior* b)
 			widget->setSingleStep(1);
 			widget->setRange(std::numeric_limits<int>::lowest(), std::numeric_limits<int>::max());
 			
-			connect(widget, QOverload<int>::of(&QSpinBox::valueChanged), [prop, b, this](int value) mutable {
-				emit beginUndoableChange();
+			connect(widget, QOverload<int>::of(&QSpinBox::valueChanged), [prop, b, propertyKey, this](int value) mutable {
+				beginEdit(propertyKey);
 
 				prop->set(value);
 				b->propertyChanged(prop, *m_level);
-
-				emit endUndoableChange();
 			});
+
+			connect(widget, &QAbstractSpinBox::editingFinished, this, &ObjectWidget::finishEdit);
 		}
 		break;
 		
@@ -166,14 +202,14 @@ QTreeWidgetItem* ObjectWidget::createBehavior(Behavior* b)
 			// widget->setRange(std::numeric_limits<unsigned int>::lowest(), std::numeric_limits<unsigned int>::max());
 			widget->setRange(0, std::numeric_limits<int>::max());
 			
-			connect(widget, QOverload<int>::of(&QSpinBox::valueChanged), [prop, b, this](int value) mutable {
-				emit beginUndoableChange();
+			connect(widget, QOverload<int>::of(&QSpinBox::valueChanged), [prop, b, propertyKey, this](int value) mutable {
+				beginEdit(propertyKey);
 
 				prop->set(static_cast<unsigned int>(value));
 				b->propertyChanged(prop, *m_level);
-
-				emit endUndoableChange();
 			});
+
+			connect(widget, &QAbstractSpinBox::editingFinished, this, &ObjectWidget::finishEdit);
 		}
 		break;
 		
@@ -186,14 +222,14 @@ QTreeWidgetItem* ObjectWidget::createBehavior(Behavior* b)
 			widget->setRange(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::max());
 			widget->setDecimals(std::numeric_limits<float>::digits10);
 			
-			connect(widget, QOverload<double>::of(&QDoubleSpinBox::valueChanged), [prop, b, this](double value) mutable {
-				emit beginUndoableChange();
+			connect(widget, QOverload<double>::of(&QDoubleSpinBox::valueChanged), [prop, b, propertyKey, this](double value) mutable {
+				beginEdit(propertyKey);
 
 				prop->set(static_cast<float>(value));
 				b->propertyChanged(prop, *m_level);
-
-				emit endUndoableChange();
 			});
+
+			connect(widget, &QAbstractSpinBox::editingFinished, this, &ObjectWidget::finishEdit);
 		}
 		break;
 		
@@ -202,14 +238,14 @@ QTreeWidgetItem* ObjectWidget::createBehavior(Behavior* b)
 			VectorWidget<Neo::Vector2>* widget;
 			setItemWidget(propItem, 1, widget = new VectorWidget<Neo::Vector2>(this));
 			
-			connect(widget, &VectorWidgetBase::valueChanged, [prop, widget, b, this]() mutable {
-				emit beginUndoableChange();
+			connect(widget, &VectorWidgetBase::valueChanged, [prop, widget, b, propertyKey, this]() mutable {
+				beginEdit(propertyKey);
 
 				prop->set(widget->value());
 				b->propertyChanged(prop, *m_level);
-
-				emit endUndoableChange();
 			});
+
+			connect(widget, &VectorWidgetBase::editingFinished, this, &ObjectWidget::finishEdit);
 		}
 		break;
 		
@@ -218,14 +254,14 @@ QTreeWidgetItem* ObjectWidget::createBehavior(Behavior* b)
 			VectorWidget<Neo::Vector3>* widget;
 			setItemWidget(propItem, 1, widget = new VectorWidget<Neo::Vector3>(this));
 			
-			connect(widget, &VectorWidgetBase::valueChanged, [prop, widget, b, this]() mutable {
-				emit beginUndoableChange();
+			connect(widget, &VectorWidgetBase::valueChanged, [prop, widget, b, propertyKey, this]() mutable {
+				beginEdit(propertyKey);
 
 				prop->set(widget->value());
 				b->propertyChanged(prop, *m_level);
-
-				emit endUndoableChange();
 			});
+
+			connect(widget, &VectorWidgetBase::editingFinished, this, &ObjectWidget::finishEdit);
 		}
 		break;
 		
@@ -234,14 +270,14 @@ QTreeWidgetItem* ObjectWidget::createBehavior(Behavior* b)
 			VectorWidget<Neo::Vector4>* widget;
 			setItemWidget(propItem, 1, widget = new VectorWidget<Neo::Vector4>(this));
 			
-			connect(widget, &VectorWidgetBase::valueChanged, [prop, widget, b, this]() mutable {
-				emit beginUndoableChange();
+			connect(widget, &VectorWidgetBase::valueChanged, [prop, widget, b, propertyKey, this]() mutable {
+				beginEdit(propertyKey);
 
 				prop->set(widget->value());
 				b->propertyChanged(prop, *m_level);
-				
-				emit endUndoableChange();
 			});
+
+			connect(widget, &VectorWidgetBase::editingFinished, this, &ObjectWidget::finishEdit);
 		}
 		break;
 		
@@ -250,13 +286,13 @@ QTreeWidgetItem* ObjectWidget::createBehavior(Behavior* b)
 			ColorButton* widget;
 			setItemWidget(propItem, 1, widget = new ColorButton(this));
 			
-			connect(widget, &ColorButton::colorChanged, [prop, b, this](const Vector4& color) mutable {
-				emit beginUndoableChange();
+			connect(widget, &ColorButton::colorChanged, [prop, b, propertyKey, this](const Vector4& color) mutable {
+				beginEdit(propertyKey);
 
 				prop->set(color);
 				b->propertyChanged(prop, *m_level);
 
-				emit endUndoableChange();
+				finishEdit();
 			});
 		}
 		break;
@@ -276,27 +312,27 @@ QTreeWidgetItem* ObjectWidget::createBehavior(Behavior* b)
 
 			setItemWidget(propItem, 1, frame);
 			
-			connect(widget, &QLineEdit::editingFinished, [prop, b, widget, this] () mutable {
-				emit beginUndoableChange();
+			connect(widget, &QLineEdit::editingFinished, [prop, b, widget, propertyKey, this] () mutable {
+				beginEdit(propertyKey);
 				prop->set(widget->text().toStdString());
 				b->propertyChanged(prop, *m_level);
-				emit endUndoableChange();
+				finishEdit();
 			});
 
-			connect(button, &QPushButton::pressed, [prop, b, widget, this] () mutable {
+			connect(button, &QPushButton::pressed, [prop, b, widget, propertyKey, this] () mutable {
 				
 				auto value = QFileDialog::getOpenFileName(widget, tr("Open File"), widget->text(), tr("All Files (*.*)"));
 
 				if(value.isEmpty())
 					return;
 
-				emit beginUndoableChange();
+				beginEdit(propertyKey);
 
 				widget->setText(value);
 				prop->set(value.toStdString());
 				b->propertyChanged(prop, *m_level);
 
-				emit endUndoableChange();
+				finishEdit();
 			});
 		}
 		break;
@@ -306,13 +342,13 @@ QTreeWidgetItem* ObjectWidget::createBehavior(Behavior* b)
 			QLineEdit* widget;
 			setItemWidget(propItem, 1, widget = new QLineEdit(this));
 			
-			connect(widget, &QLineEdit::editingFinished, [prop, b, widget, this] () mutable {
-				emit beginUndoableChange();
+			connect(widget, &QLineEdit::editingFinished, [prop, b, widget, propertyKey, this] () mutable {
+				beginEdit(propertyKey);
 
 				prop->set(widget->text().toStdString());
 				b->propertyChanged(prop, *m_level);
 
-				emit endUndoableChange();
+				finishEdit();
 			});
 		}
 		break;
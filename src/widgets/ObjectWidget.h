@@ -5,6 +5,7 @@
 #include <Object.h>
 #include "VectorWidget.h"
 #include <QCheckBox>
+#include <QTimer>
 
 namespace Neo 
 {
@@ -24,15 +25,25 @@ public:
 public slots:
 	void setObject(ObjectHandle h);
 	void updateObject(ObjectHandle h);
+
+	/// Ends the current edit burst so it gets committed to the undo stack
+	void finishEdit();
 	
 signals:
+	/// Emitted whenever a value of the object is about to change
 	void objectChanged(ObjectHandle);
 	void requestNameChange(ObjectHandle, QString);
 	
-	void beginUndoableChange();
-	void endUndoableChange();
+	/// Emitted once per edit burst, i.e. when a value starts changing.
+	/// Consecutive bursts of the same property can be merged into one undo step.
+	void beginUndoableChange(ObjectHandle, QString property);
+
+	/// Emitted once the burst is over and the property has its final value
+	void endUndoableChange(ObjectHandle, QString property);
 
 private:
+	void beginEdit(const QString& property);
+
 	QTreeWidgetItem* createTransform(ObjectHandle o);
 	QTreeWidgetItem* createBehavior(Behavior* b);
 	QTreeWidgetItem* createCustomBehavior(Behavior* b, QTreeWidgetItem* parent);
@@ -43,6 +54,9 @@ private:
 	QCheckBox* m_active;
 
 	std::shared_ptr<Level> m_level = nullptr;
+
+	QTimer m_editTimer;
+	QString m_editProperty; // The property of the running edit burst
 };
 
 }
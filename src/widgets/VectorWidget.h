@@ -25,6 +25,7 @@ public:
 	}
 signals:
 	void valueChanged();
+	void editingFinished();
 };
 
 template<typename T>
@@ -107,6 +108,7 @@ private:
 			layout->addWidget(m_fields[i]);
 			
 			connect(m_fields[i], QOverload<double>::of(&QDoubleSpinBox::valueChanged), [this](double) { emit valueChanged(); });
+			connect(m_fields[i], &QDoubleSpinBox::editingFinished, this, &VectorWidgetBase::editingFinished);
 		}
 	}
 	